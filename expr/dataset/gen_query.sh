@@ -15,129 +15,54 @@ script_dir=$(get_script_dir)
 
 source "${script_dir}/../common.sh"
 
-function gen_point_query_contains() {
-  query_type="point-contains"
-  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
-    output_dir="${QUERY_ROOT}/${query_type}_queries_${CONTAINS_QUERY_SIZE}"
-    output="${output_dir}/${wkt_file}"
-
-    if [[ ! -f "$output" ]]; then
-      mkdir -p "$output_dir"
-      echo "Generating $output"
-      "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
-        -serialize "$SERIALIZE_ROOT" \
-        -output "$output" \
-        -num_queries $CONTAINS_QUERY_SIZE \
-        -query_type "$query_type"
+# Generates the missing query files of a dataset with a single run of gen,
+# which loads and indexes the dataset once for all of them
+function gen_queries() {
+  wkt_file="$1"
+  shift
+  declare -A seen
+  workloads=""
+
+  for spec in "$@"; do
+    IFS=":" read -r -a fields <<<"$spec"
+    if [[ ${#fields[@]} -eq 3 ]]; then
+      query_dir="${fields[0]}_select_${fields[1]}_queries_${fields[2]}"
+    else
+      query_dir="${fields[0]}_queries_${fields[1]}"
     fi
-  done
-}
 
-function gen_point_query_contains_vary_size() {
-  query_type="point-contains"
-  wkt_file="$DATASET_VARY_SIZE"
-  for query_size in "${QUERY_VARY_SIZES_CONTAINS[@]}"; do
-    output_dir="${QUERY_ROOT}/${query_type}_queries_${query_size}"
-    output="${output_dir}/${wkt_file}"
-
-    if [[ ! -f "$output" ]]; then
-      mkdir -p "$output_dir"
-      echo "Generating $output, size $query_size"
-      "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
-        -serialize "$SERIALIZE_ROOT" \
-        -output "$output" \
-        -num_queries $query_size \
-        -query_type "$query_type"
+    if [[ ! -f "${QUERY_ROOT}/${query_dir}/${wkt_file}" && -z "${seen[$spec]}" ]]; then
+      seen[$spec]=1
+      workloads="${workloads:+${workloads},}${spec}"
     fi
   done
-}
-
-function gen_range_query_contains() {
-  query_type="range-contains"
-  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
-    output_dir="${QUERY_ROOT}/${query_type}_queries_${CONTAINS_QUERY_SIZE}"
-    output="${output_dir}/${wkt_file}"
 
-    if [[ ! -f "$output" ]]; then
-      mkdir -p "$output_dir"
-      echo "Generating $output"
-      "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
-        -serialize "$SERIALIZE_ROOT" \
-        -output "$output" \
-        -num_queries $CONTAINS_QUERY_SIZE \
-        -query_type "$query_type"
-    fi
-  done
+  if [[ -n "$workloads" ]]; then
+    mkdir -p "$QUERY_ROOT"
+    echo "Generating $workloads for $wkt_file"
+    "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
+      -serialize "$SERIALIZE_ROOT" \
+      -output "$QUERY_ROOT" \
+      -workloads "$workloads"
+  fi
 }
 
-function gen_range_query_contains_vary_size() {
-  query_type="range-contains"
-  wkt_file="$DATASET_VARY_SIZE"
-  for query_size in "${QUERY_VARY_SIZES_CONTAINS[@]}"; do
-    output_dir="${QUERY_ROOT}/${query_type}_queries_${query_size}"
-    output="${output_dir}/${wkt_file}"
-
-    if [[ ! -f "$output" ]]; then
-      mkdir -p "$output_dir"
-      echo "Generating $output"
-      "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
-        -serialize "$SERIALIZE_ROOT" \
-        -output "$output" \
-        -num_queries $query_size \
-        -query_type "$query_type"
-    fi
+for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+  specs=("point-contains:${CONTAINS_QUERY_SIZE}"
+    "range-contains:${CONTAINS_QUERY_SIZE}")
+  for selectivity in "${RANGE_QUERY_INTERSECTS_SELECTIVITIES[@]}"; do
+    specs+=("range-intersects:${selectivity}:${INTERSECTS_QUERY_SIZE}")
+    #specs+=("range-intersects:${selectivity}:${RAY_DUP_INTERSECTS_QUERY_SIZE}")
   done
-}
 
-function gen_range_query_intersects() {
-  query_type="range-intersects"
-  query_size=$1
-  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
-    for selectivity in "${RANGE_QUERY_INTERSECTS_SELECTIVITIES[@]}"; do
-      output_dir="${QUERY_ROOT}/${query_type}_select_${selectivity}_queries_${query_size}"
-      output="${output_dir}/${wkt_file}"
-
-      if [[ ! -f "$output" ]]; then
-        mkdir -p "$output_dir"
-        echo "Generating $output"
-        "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
-          -serialize "$SERIALIZE_ROOT" \
-          -output "$output" \
-          -selectivity $selectivity \
-          -num_queries $query_size \
-          -query_type "$query_type"
-      fi
+  if [[ "$wkt_file" == "$DATASET_VARY_SIZE" ]]; then
+    for query_size in "${QUERY_VARY_SIZES_CONTAINS[@]}"; do
+      specs+=("point-contains:${query_size}" "range-contains:${query_size}")
     done
-  done
-}
-
-function gen_range_query_intersects_vary_size() {
-  query_type="range-intersects"
-  selectivity=$1
-  wkt_file="$DATASET_VARY_SIZE"
-  for query_size in "${QUERY_VARY_SIZES_INTERSECTS[@]}"; do
-    output_dir="${QUERY_ROOT}/${query_type}_select_${selectivity}_queries_${query_size}"
-    output="${output_dir}/${wkt_file}"
-
-    if [[ ! -f "$output" ]]; then
-      mkdir -p "$output_dir"
-      echo "Generating $output"
-      "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
-        -serialize "$SERIALIZE_ROOT" \
-        -output "$output" \
-        -selectivity $selectivity \
-        -num_queries $query_size \
-        -query_type "$query_type"
-    fi
-  done
-}
-
-gen_point_query_contains
-gen_point_query_contains_vary_size
-
-gen_range_query_contains
-gen_range_query_contains_vary_size
+    for query_size in "${QUERY_VARY_SIZES_INTERSECTS[@]}"; do
+      specs+=("range-intersects:0.001:${query_size}")
+    done
+  fi
 
-gen_range_query_intersects $INTERSECTS_QUERY_SIZE
-#gen_range_query_intersects $RAY_DUP_INTERSECTS_QUERY_SIZE
-gen_range_query_intersects_vary_size "0.001"
+  gen_queries "$wkt_file" "${specs[@]}"
+done
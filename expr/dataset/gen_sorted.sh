@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+
+# Function to resolve the script path
+get_script_dir() {
+  local source="${BASH_SOURCE[0]}"
+  while [ -h "$source" ]; do
+    local dir
+    dir=$(dirname "$source")
+    source=$(readlink "$source")
+    [[ $source != /* ]] && source="$dir/$source"
+  done
+  echo "$(cd -P "$(dirname "$source")" >/dev/null 2>&1 && pwd)"
+}
+script_dir=$(get_script_dir)
+
+source "${script_dir}/../common.sh"
+
+# Writes each dataset sorted in the given order to polygons_<order>, so it can
+# be loaded pre-sorted instead of passing -reorder on every run
+function gen_sorted_datasets() {
+  reorder="$1"
+  output_dir="${DATASET_ROOT}/polygons_${reorder}"
+  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+    output="${output_dir}/${wkt_file}"
+
+    if [[ ! -f "$output" ]]; then
+      mkdir -p "$output_dir"
+      echo "Generating $output"
+      "$BENCHMARK_ROOT"/gen -input "${DATASET_ROOT}/polygons/${wkt_file}" \
+        -serialize "$SERIALIZE_ROOT" \
+        -output "$output" \
+        -reorder "$reorder" \
+        -query_type "reorder"
+    fi
+  done
+}
+
+for reorder in "morton" "hilbert" "str"; do
+  gen_sorted_datasets "$reorder"
+done
@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+
+# Function to resolve the script path
+get_script_dir() {
+  local source="${BASH_SOURCE[0]}"
+  while [ -h "$source" ]; do
+    local dir
+    dir=$(dirname "$source")
+    source=$(readlink "$source")
+    [[ $source != /* ]] && source="$dir/$source"
+  done
+  echo "$(cd -P "$(dirname "$source")" >/dev/null 2>&1 && pwd)"
+}
+script_dir=$(get_script_dir)
+
+source "${script_dir}/../common.sh"
+
+log_dir="${script_dir}/logs"
+
+# Joins every ordered pair of datasets, the index of a nested loop join is
+# built on the first one, so both size ratios are covered
+function run_join() {
+  index_type="$1"
+  for geom_file in "${DATASET_WKT_FILES[@]}"; do
+    for query_file in "${DATASET_WKT_FILES[@]}"; do
+      if [[ "$geom_file" == "$query_file" ]]; then
+        continue
+      fi
+      log="${log_dir}/join/${index_type}/${geom_file}_${query_file}.log"
+
+      if [[ ! -f "${log}" ]]; then
+        echo "${log}" | xargs dirname | xargs mkdir -p
+
+        echo "Joining $geom_file with $query_file"
+        cmd="$BENCHMARK_ROOT/query -geom ${DATASET_ROOT}/polygons/${geom_file} \
+          -query ${DATASET_ROOT}/polygons/${query_file} \
+          -serialize $SERIALIZE_ROOT \
+          -query_type join \
+          -index_type $index_type"
+
+        echo "$cmd" >"${log}.tmp"
+        eval "$cmd" 2>&1 | tee -a "${log}.tmp"
+
+        if grep -q "Query Time" "${log}.tmp"; then
+          mv "${log}.tmp" "${log}"
+        fi
+      fi
+    done
+  done
+}
+
+# RTSpatial is left out, its result queue is sized as a fraction of the
+# Cartesian product, which is tens of GB for these pairs
+for index_type in "pbsm" "sweep" "rtree" "pargeo" "grid" "grid-adaptive" \
+  "quadtree" "lbvh-cpu"; do
+  run_join "$index_type"
+done
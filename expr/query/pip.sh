@@ -50,6 +50,40 @@ function run_pip() {
   done
 }
 
+# Runs a CPU backend with each value of a tuning flag
+function run_pip_option() {
+  query_type="pip"
+  index_type="$1"
+  option="$2"
+  shift 2
+  for value in "$@"; do
+    for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+      query_dir="${QUERY_ROOT}/point-contains_queries_${CONTAINS_QUERY_SIZE}"
+      query="${query_dir}/${wkt_file}"
+      log="${log_dir}/${query_type}_${option}_${value}_queries_${CONTAINS_QUERY_SIZE}/${index_type}/${wkt_file}.log"
+
+      if [[ ! -f "${log}" ]]; then
+        echo "${log}" | xargs dirname | xargs mkdir -p
+
+        echo "Running query $query"
+        cmd="$BENCHMARK_ROOT/pip -geom ${DATASET_ROOT}/polygons/${wkt_file} \
+          -query $query \
+          -serialize $SERIALIZE_ROOT \
+          -query_type $query_type \
+          -index_type $index_type \
+          -${option} ${value}"
+
+        echo "$cmd" >"${log}.tmp"
+        eval "$cmd" 2>&1 | tee -a "${log}.tmp"
+
+        if grep -q "Query Time" "${log}.tmp"; then
+          mv "${log}.tmp" "${log}"
+        fi
+      fi
+    done
+  done
+}
+
 function run_pip_rayjoin() {
   query_type="pip"
   index_type="rayjoin"
@@ -83,5 +117,13 @@ function run_pip_rayjoin() {
 }
 
 run_pip "rtspatial"
+run_pip "rtspatial-cpu"
+run_pip "rtree"
+run_pip "grid"
+run_pip "quadtree"
+run_pip "lbvh-cpu"
+run_pip "geos-prepared"
+run_pip_option "rtree" pip_slab_threshold 256 1024 4096
+run_pip_option "rtree" pip_raster_resolution 8 16 32
 run_pip "cuspatial"
 run_pip_rayjoin
\ No newline at end of file
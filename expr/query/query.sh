@@ -50,6 +50,67 @@ function run_point_query_contains() {
   done
 }
 
+# kNN queries reuse the point-contains query points
+function run_knn_query() {
+  index_type="$1"
+  k="$2"
+  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+    query_dir="${QUERY_ROOT}/point-contains_queries_${CONTAINS_QUERY_SIZE}"
+    query="${query_dir}/${wkt_file}"
+    log="${log_dir}/knn_k_${k}_queries_${CONTAINS_QUERY_SIZE}/${index_type}/${wkt_file}.log"
+
+    if [[ ! -f "${log}" ]]; then
+      echo "${log}" | xargs dirname | xargs mkdir -p
+
+      echo "Running query $query"
+      cmd="$BENCHMARK_ROOT/query -geom ${DATASET_ROOT}/polygons/${wkt_file} \
+        -query $query \
+        -serialize $SERIALIZE_ROOT \
+        -query_type knn \
+        -index_type $index_type \
+        -k $k \
+        -check"
+
+      echo "$cmd" >"${log}.tmp"
+      eval "$cmd" 2>&1 | tee -a "${log}.tmp"
+
+      if grep -q "Query Time" "${log}.tmp"; then
+        mv "${log}.tmp" "${log}"
+      fi
+    fi
+  done
+}
+
+# Within-distance queries reuse the point-contains query points
+function run_within_distance_query() {
+  index_type="$1"
+  distance="$2"
+  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+    query_dir="${QUERY_ROOT}/point-contains_queries_${CONTAINS_QUERY_SIZE}"
+    query="${query_dir}/${wkt_file}"
+    log="${log_dir}/within-distance_${distance}_queries_${CONTAINS_QUERY_SIZE}/${index_type}/${wkt_file}.log"
+
+    if [[ ! -f "${log}" ]]; then
+      echo "${log}" | xargs dirname | xargs mkdir -p
+
+      echo "Running query $query"
+      cmd="$BENCHMARK_ROOT/query -geom ${DATASET_ROOT}/polygons/${wkt_file} \
+        -query $query \
+        -serialize $SERIALIZE_ROOT \
+        -query_type within-distance \
+        -index_type $index_type \
+        -distance $distance"
+
+      echo "$cmd" >"${log}.tmp"
+      eval "$cmd" 2>&1 | tee -a "${log}.tmp"
+
+      if grep -q "Query Time" "${log}.tmp"; then
+        mv "${log}.tmp" "${log}"
+      fi
+    fi
+  done
+}
+
 function run_point_query_contains_vary_size() {
   query_type="point-contains"
   index_type="$1"
@@ -177,6 +238,43 @@ function run_range_query_intersects() {
   done
 }
 
+# Counts the boxes intersecting the range-intersects queries, the aggregate
+# R-tree against enumerating and counting on the other backends. With
+# range-count-contained, the boxes inside them, which only the aggregate R-tree
+# counts
+function run_range_count_query() {
+  index_type="$1"
+  query_type="${2:-range-count}"
+  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+    for ((i = 0; i < ${#RANGE_QUERY_INTERSECTS_SELECTIVITIES[@]}; i++)); do
+      selectivity=${RANGE_QUERY_INTERSECTS_SELECTIVITIES[$i]}
+      load_factor=${RANGE_QUERY_INTERSECTS_LOAD_FACTORS[$i]}
+      query_dir="${QUERY_ROOT}/range-intersects_select_${selectivity}_queries_${INTERSECTS_QUERY_SIZE}"
+      query="${query_dir}/${wkt_file}"
+      log="${log_dir}/${query_type}_select_${selectivity}_queries_${INTERSECTS_QUERY_SIZE}/${index_type}/${wkt_file}.log"
+
+      if [[ ! -f "${log}" ]]; then
+        echo "$log" | xargs dirname | xargs mkdir -p
+
+        echo "Running query $query"
+        cmd="${BENCHMARK_ROOT}/query -geom ${DATASET_ROOT}/polygons/${wkt_file} \
+          -query $query \
+          -serialize $SERIALIZE_ROOT \
+          -query_type $query_type \
+          -index_type $index_type \
+          -load_factor $load_factor"
+
+        echo "$cmd" >"${log}.tmp"
+        eval "$cmd" 2>&1 | tee -a "${log}.tmp"
+
+        if grep -q "Query Time" "${log}.tmp"; then
+          mv "${log}.tmp" "${log}"
+        fi
+      fi
+    done
+  done
+}
+
 function run_range_query_intersects_vary_size() {
   query_type="range-intersects"
   index_type="$1"
@@ -209,6 +307,42 @@ function run_range_query_intersects_vary_size() {
   done
 }
 
+function run_range_query_refine() {
+  query_type="$1"
+  index_type="$2"
+  refine="$3"
+  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+    if [[ $query_type == "range-contains" ]]; then
+      query_name="${query_type}_queries_${CONTAINS_QUERY_SIZE}"
+      load_factor="0.001"
+    else
+      query_name="${query_type}_select_0.001_queries_${INTERSECTS_QUERY_SIZE}"
+      load_factor="0.0015"
+    fi
+    query="${QUERY_ROOT}/${query_name}/${wkt_file}"
+    log="${log_dir}/${query_name}_refine_${refine}/${index_type}/${wkt_file}.log"
+
+    if [[ ! -f "${log}" ]]; then
+      echo "$log" | xargs dirname | xargs mkdir -p
+
+      echo "Running query $query"
+      cmd="$BENCHMARK_ROOT/query -geom ${DATASET_ROOT}/polygons/${wkt_file} \
+        -query $query \
+        -serialize $SERIALIZE_ROOT \
+        -query_type $query_type \
+        -index_type $index_type \
+        -refine $refine \
+        -load_factor $load_factor"
+
+      echo "$cmd" >"${log}.tmp"
+      eval "$cmd" 2>&1 | tee -a "${log}.tmp"
+
+      if grep -q "Refine Time" "${log}.tmp"; then
+        mv "${log}.tmp" "${log}"
+      fi
+    fi
+  done
+}
 function vary_parallelism_range_query_intersects() {
   query_type="range-intersects"
   index_type="rtspatial-vary-parallelism"
@@ -246,17 +380,44 @@ CPU=0
 GPU=1
 
 if [[ $CPU -eq 1 ]]; then
-  for index_type in "rtree" "cgal" "pargeo"; do
+  for index_type in "rtree" "cgal" "pargeo" "grid" "grid-adaptive" "quadtree" \
+    "lbvh-cpu" "rtspatial-cpu"; do
     run_point_query_contains "$index_type"
     run_point_query_contains_vary_size "$index_type"
   done
 
-  for index_type in "rtree" "glin"; do
+  for index_type in "rtree" "glin" "cgal" "pargeo" "grid" "grid-adaptive" \
+    "quadtree" "lbvh-cpu" "rtspatial-cpu" "sweep"; do
     run_range_query_contains "$index_type"
     run_range_query_contains_vary_size "$index_type"
     run_range_query_intersects "$index_type"
     run_range_query_intersects_vary_size "$index_type"
   done
+
+  for index_type in "artree" "rtree" "glin" "pargeo" "grid" "grid-adaptive" \
+    "quadtree" "lbvh-cpu" "rtspatial-cpu" "sweep"; do
+    run_range_count_query "$index_type"
+  done
+  run_range_count_query "artree" "range-count-contained"
+
+  for query_type in "range-intersects" "range-contains"; do
+    for refine in "exact" "geos"; do
+      run_range_query_refine "$query_type" "rtree" "$refine"
+    done
+  done
+
+  for index_type in "rtree" "lbvh-cpu"; do
+    for k in 1 10 100; do
+      run_knn_query "$index_type" "$k"
+    done
+  done
+
+  for index_type in "rtree" "cgal" "pargeo" "grid" "grid-adaptive" "quadtree" \
+    "lbvh-cpu"; do
+    for distance in "0.0001" "0.001" "0.01"; do
+      run_within_distance_query "$index_type" "$distance"
+    done
+  done
 fi
 
 if [[ $GPU -eq 1 ]]; then
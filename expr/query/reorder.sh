@@ -0,0 +1,81 @@
+#!/usr/bin/env bash
+
+# Function to resolve the script path
+get_script_dir() {
+  local source="${BASH_SOURCE[0]}"
+  while [ -h "$source" ]; do
+    local dir
+    dir=$(dirname "$source")
+    source=$(readlink "$source")
+    [[ $source != /* ]] && source="$dir/$source"
+  done
+  echo "$(cd -P "$(dirname "$source")" >/dev/null 2>&1 && pwd)"
+}
+script_dir=$(get_script_dir)
+
+source "${script_dir}/../common.sh"
+
+log_dir="${script_dir}/logs"
+
+# Cache misses are collected with perf when it is available
+perf_cmd=""
+if command -v perf >/dev/null 2>&1; then
+  perf_cmd="perf stat -e cache-references,cache-misses"
+fi
+
+# The last argument picks what is sorted, "reorder_queries" for the queries
+# or "reorder" for the indexed geometries
+function run_reorder_queries() {
+  query_type="$1"
+  index_type="$2"
+  reorder="$3"
+  reorder_flag="${4:-reorder_queries}"
+  if [[ $query_type == "range-intersects" ]]; then
+    query_dir="${QUERY_ROOT}/${query_type}_select_0.001_queries_${INTERSECTS_QUERY_SIZE}"
+  else
+    query_dir="${QUERY_ROOT}/${query_type}_queries_${CONTAINS_QUERY_SIZE}"
+  fi
+
+  for wkt_file in "${DATASET_WKT_FILES[@]}"; do
+    query="${query_dir}/${wkt_file}"
+    log="${log_dir}/${reorder_flag}_${reorder}_${query_type}/${index_type}/${wkt_file}.log"
+
+    if [[ ! -f "${log}" ]]; then
+      echo "${log}" | xargs dirname | xargs mkdir -p
+
+      echo "Running query $query"
+      cmd="$perf_cmd $BENCHMARK_ROOT/query -geom ${DATASET_ROOT}/polygons/${wkt_file} \
+        -query $query \
+        -serialize $SERIALIZE_ROOT \
+        -query_type $query_type \
+        -index_type $index_type \
+        -${reorder_flag} $reorder \
+        -load_factor 0.001"
+
+      echo "$cmd" >"${log}.tmp"
+      eval "$cmd" 2>&1 | tee -a "${log}.tmp"
+
+      if grep -q "Query Time" "${log}.tmp"; then
+        mv "${log}.tmp" "${log}"
+      fi
+    fi
+  done
+}
+
+for reorder_flag in "reorder_queries" "reorder"; do
+  for reorder in "none" "morton" "hilbert" "str"; do
+    for index_type in "rtree" "cgal" "pargeo" "grid" "grid-adaptive" \
+      "quadtree" "lbvh-cpu" "rtspatial-cpu"; do
+      run_reorder_queries "point-contains" "$index_type" "$reorder" \
+        "$reorder_flag"
+    done
+
+    for index_type in "rtree" "glin" "cgal" "pargeo" "grid" "grid-adaptive" \
+      "quadtree" "lbvh-cpu" "rtspatial-cpu" "sweep"; do
+      run_reorder_queries "range-contains" "$index_type" "$reorder" \
+        "$reorder_flag"
+      run_reorder_queries "range-intersects" "$index_type" "$reorder" \
+        "$reorder_flag"
+    done
+  done
+done
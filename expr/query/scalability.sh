@@ -19,13 +19,18 @@ log_dir="${script_dir}/logs"
 
 function run_point_query_contains() {
   query_type="point-contains"
+  index_type="${1:-rtspatial}"
 
   for dist in "uniform" "gaussian"; do
     for size in "${SYNTHETIC_DATA_SIZES[@]}"; do
       wkt_file="${dist}_n_${size}.wkt"
       query_dir="${QUERY_ROOT}/${query_type}_queries_${SYNTHETIC_QUERY_SIZE}"
       query="${query_dir}/${wkt_file}"
-      log="${log_dir}/scalability_${size}_${query_type}/${wkt_file}.log"
+      log_subdir="scalability_${size}_${query_type}"
+      if [[ $index_type != "rtspatial" ]]; then
+        log_subdir="${log_subdir}/${index_type}"
+      fi
+      log="${log_dir}/${log_subdir}/${wkt_file}.log"
 
       if [[ ! -f "${log}" ]]; then
         echo "${log}" | xargs dirname | xargs mkdir -p
@@ -35,7 +40,7 @@ function run_point_query_contains() {
           -query $query \
           -serialize $SERIALIZE_ROOT \
           -query_type $query_type \
-          -index_type rtspatial \
+          -index_type $index_type \
           -load_factor 0.0001"
 
         echo "$cmd" >"${log}.tmp"
@@ -114,5 +119,6 @@ function run_range_query_intersects() {
 }
 
 run_point_query_contains
+run_point_query_contains "quadtree"
 run_range_query_contains
 run_range_query_intersects
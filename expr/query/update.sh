@@ -42,9 +42,15 @@ function run_update() {
 
 function run_update_batch() {
   op=$1
+  index_type=${2:-rtspatial}
+  # Keep the original layout for rtspatial logs
+  suffix=""
+  if [[ "$index_type" != "rtspatial" ]]; then
+    suffix="_${index_type}"
+  fi
   for wkt_file in "uniform_n_50000000.wkt" "gaussian_n_50000000.wkt"; do
     for batch in "${BATCH_SIZES[@]}"; do
-      log="${log_dir}/${op}_batch_${batch}/${wkt_file}.log"
+      log="${log_dir}/${op}_batch_${batch}${suffix}/${wkt_file}.log"
 
       if [[ ! -f "${log}" ]]; then
         echo "${log}" | xargs dirname | xargs mkdir -p
@@ -52,7 +58,7 @@ function run_update_batch() {
         cmd="$BENCHMARK_ROOT/query -geom ${DATASET_ROOT}/synthetic/${wkt_file} \
         -serialize $SERIALIZE_ROOT \
         -query_type $op \
-        -index_type rtspatial \
+        -index_type $index_type \
         -batch $batch"
 
         echo "$cmd" >"${log}.tmp"
@@ -67,6 +73,11 @@ function run_update_batch() {
 }
 
 function run_update_query() {
+  index_type=${1:-rtspatial}
+  suffix=""
+  if [[ "$index_type" != "rtspatial" ]]; then
+    suffix="_${index_type}"
+  fi
   selectivity="0.001"
   for wkt_file in "${DATASET_WKT_FILES[@]}"; do
     for query_type in "point-contains" "range-contains" "range-intersects"; do
@@ -81,7 +92,7 @@ function run_update_query() {
       query="${query_dir}/${wkt_file}"
 
       for ratio in "${UPDATE_RATIOS[@]}"; do
-        log="${log_dir}/${query_type}_update_${ratio}_queries_${query_size}/${wkt_file}.log"
+        log="${log_dir}/${query_type}_update_${ratio}_queries_${query_size}${suffix}/${wkt_file}.log"
 
         if [[ ! -f "${log}" ]]; then
           echo "${log}" | xargs dirname | xargs mkdir -p
@@ -90,7 +101,7 @@ function run_update_query() {
         -query $query \
         -serialize $SERIALIZE_ROOT \
         -query_type $query_type \
-        -index_type rtspatial \
+        -index_type $index_type \
         -update_ratio $ratio"
 
           echo "$cmd" >"${log}.tmp"
@@ -111,4 +122,10 @@ run_update "deletion"
 run_update_batch "insertion"
 run_update_batch "deletion"
 
+for index_type in "pargeo-logtree" "pargeo-bhl" "pargeo-co" "rtspatial-cpu"; do
+  run_update_batch "insertion" $index_type
+  run_update_batch "deletion" $index_type
+done
+
 run_update_query
+run_update_query "rtspatial-cpu"
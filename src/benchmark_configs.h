@@ -2,11 +2,14 @@
 #ifndef SPATIALQUERYBENCHMARK_CONFIGS_H
 #define SPATIALQUERYBENCHMARK_CONFIGS_H
 #include "flags.h"
+#include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 struct BenchmarkConfig {
   enum class QueryType {
@@ -17,18 +20,39 @@ struct BenchmarkConfig {
     kInsertion,
     kDeletion,
     kPIP,
+    kJoin,
+    kKNN,
+    kWithinDistance,
+    kRangeCount,
+    kRangeCountContained,
   };
 
   enum class IndexType {
+    kARTree,
     kCGAL,
+    kGEOSPrepared,
     kGLIN,
+    kGrid,
+    kGridAdaptive,
     kLBVH,
+    kLBVHCPU,
     kParGeo,
+    kParGeoLogTree,
+    kParGeoBHL,
+    kParGeoCO,
+    kPBSM,
+    kQuadTree,
     kRTree,
     kRTSpatial,
-    kRTSpatialVaryParallelism
+    kRTSpatialCPU,
+    kRTSpatialVaryParallelism,
+    kSweep
   };
 
+  enum class ReorderType { kNone, kMorton, kHilbert, kSTR };
+
+  enum class RefineType { kNone, kExact, kGEOS };
+
   std::string geom;
   std::string query;
   std::string serialize;
@@ -43,6 +67,32 @@ struct BenchmarkConfig {
   float load_factor;
   int batch;
   float update_ratio;
+  int glin_cell_bits;
+  std::vector<double> glin_piece_limits;
+  ReorderType reorder;
+  ReorderType reorder_queries;
+  int k;
+  bool check;
+  double distance;
+  int pip_slab_threshold;
+  int pip_raster_resolution;
+  RefineType refine;
+  bool csr;
+
+  static ReorderType ParseReorderType(const std::string &flag,
+                                      const std::string &value) {
+    if (value == "none") {
+      return ReorderType::kNone;
+    } else if (value == "morton") {
+      return ReorderType::kMorton;
+    } else if (value == "hilbert") {
+      return ReorderType::kHilbert;
+    } else if (value == "str") {
+      return ReorderType::kSTR;
+    }
+    std::cerr << "Invalid " << flag << " " << value << std::endl;
+    abort();
+  }
 
   static BenchmarkConfig GetConfig() {
     BenchmarkConfig config;
@@ -60,6 +110,13 @@ struct BenchmarkConfig {
     config.avg_time = FLAGS_avg_time;
     config.batch = FLAGS_batch;
     config.update_ratio = FLAGS_update_ratio;
+    config.glin_cell_bits = FLAGS_glin_cell_bits;
+    config.k = FLAGS_k;
+    config.check = FLAGS_check;
+    config.distance = FLAGS_distance;
+    config.pip_slab_threshold = FLAGS_pip_slab_threshold;
+    config.pip_raster_resolution = FLAGS_pip_raster_resolution;
+    config.csr = FLAGS_csr;
 
     if (config.limit == -1) {
       config.limit = std::numeric_limits<int>::max();
@@ -68,6 +125,76 @@ struct BenchmarkConfig {
     if (config.parallelism == -1) {
       config.parallelism = std::thread::hardware_concurrency();
     }
+    // parlay reads this once when its scheduler starts, so it has to be set
+    // before any backend touches parlay
+    setenv("PARLAY_NUM_THREADS", std::to_string(config.parallelism).c_str(),
+           1);
+
+    if (config.k < 1) {
+      std::cerr << "Invalid k " << config.k << std::endl;
+      abort();
+    }
+
+    if (config.distance < 0) {
+      std::cerr << "Invalid distance " << config.distance << std::endl;
+      abort();
+    }
+
+    if (config.pip_slab_threshold < 0) {
+      std::cerr << "Invalid pip_slab_threshold " << config.pip_slab_threshold
+                << std::endl;
+      abort();
+    }
+
+    if (config.pip_raster_resolution < 0 ||
+        config.pip_raster_resolution > 1024) {
+      std::cerr << "Invalid pip_raster_resolution "
+                << config.pip_raster_resolution << std::endl;
+      abort();
+    }
+
+    if (FLAGS_refine == "none") {
+      config.refine = RefineType::kNone;
+    } else if (FLAGS_refine == "exact") {
+      config.refine = RefineType::kExact;
+    } else if (FLAGS_refine == "geos") {
+      config.refine = RefineType::kGEOS;
+    } else {
+      std::cerr << "Invalid refine " << FLAGS_refine << std::endl;
+      abort();
+    }
+
+    // Z keys are stored as doubles, so both axes together must fit in 53 bits
+    if (config.glin_cell_bits < 1 || config.glin_cell_bits > 26) {
+      std::cerr << "Invalid glin_cell_bits " << config.glin_cell_bits
+                << std::endl;
+      abort();
+    }
+
+    std::stringstream ss(FLAGS_glin_piece_limit);
+    std::string piece_limit;
+
+    while (std::getline(ss, piece_limit, ',')) {
+      char *end;
+      double val = strtod(piece_limit.c_str(), &end);
+
+      if (piece_limit.empty() || *end != '\0' || val <= 0) {
+        std::cerr << "Invalid glin_piece_limit " << FLAGS_glin_piece_limit
+                  << std::endl;
+        abort();
+      }
+      config.glin_piece_limits.push_back(val);
+    }
+
+    if (config.glin_piece_limits.empty()) {
+      std::cerr << "Invalid glin_piece_limit " << FLAGS_glin_piece_limit
+                << std::endl;
+      abort();
+    }
+
+    config.reorder = ParseReorderType("reorder", FLAGS_reorder);
+    config.reorder_queries =
+        ParseReorderType("reorder_queries", FLAGS_reorder_queries);
 
     if (access(config.geom.c_str(), R_OK) != 0) {
       std::cerr << "Cannot open " << config.geom << std::endl;
@@ -93,25 +220,77 @@ struct BenchmarkConfig {
       config.query_type = BenchmarkConfig::QueryType::kDeletion;
     } else if (FLAGS_query_type == "pip") {
       config.query_type = BenchmarkConfig::QueryType::kPIP;
+    } else if (FLAGS_query_type == "join") {
+      config.query_type = BenchmarkConfig::QueryType::kJoin;
+    } else if (FLAGS_query_type == "knn") {
+      config.query_type = BenchmarkConfig::QueryType::kKNN;
+    } else if (FLAGS_query_type == "within-distance") {
+      config.query_type = BenchmarkConfig::QueryType::kWithinDistance;
+    } else if (FLAGS_query_type == "range-count") {
+      config.query_type = BenchmarkConfig::QueryType::kRangeCount;
+    } else if (FLAGS_query_type == "range-count-contained") {
+      config.query_type = BenchmarkConfig::QueryType::kRangeCountContained;
     } else {
       std::cerr << "Invalid query " << FLAGS_query << std::endl;
       abort();
     }
 
-    if (FLAGS_index_type == "cgal") {
+    // Only the range queries have polygons to refine against
+    if (config.refine != RefineType::kNone &&
+        config.query_type != QueryType::kRangeContains &&
+        config.query_type != QueryType::kRangeIntersects) {
+      std::cerr << "Refine is not supported with " << FLAGS_query_type
+                << std::endl;
+      abort();
+    }
+
+    // Loading and updates return no results to group
+    if (config.csr && (config.query_type == QueryType::kBulkLoading ||
+                       config.query_type == QueryType::kInsertion ||
+                       config.query_type == QueryType::kDeletion)) {
+      std::cerr << "CSR is not supported with " << FLAGS_query_type
+                << std::endl;
+      abort();
+    }
+
+    if (FLAGS_index_type == "artree") {
+      config.index_type = IndexType::kARTree;
+    } else if (FLAGS_index_type == "cgal") {
       config.index_type = IndexType::kCGAL;
     } else if (FLAGS_index_type == "rtree") {
       config.index_type = IndexType::kRTree;
     } else if (FLAGS_index_type == "rtspatial") {
       config.index_type = IndexType::kRTSpatial;
+    } else if (FLAGS_index_type == "rtspatial-cpu") {
+      config.index_type = IndexType::kRTSpatialCPU;
     } else if (FLAGS_index_type == "rtspatial-vary-parallelism") {
       config.index_type = IndexType::kRTSpatialVaryParallelism;
     } else if (FLAGS_index_type == "pargeo") {
       config.index_type = IndexType::kParGeo;
+    } else if (FLAGS_index_type == "pargeo-logtree") {
+      config.index_type = IndexType::kParGeoLogTree;
+    } else if (FLAGS_index_type == "pargeo-bhl") {
+      config.index_type = IndexType::kParGeoBHL;
+    } else if (FLAGS_index_type == "pargeo-co") {
+      config.index_type = IndexType::kParGeoCO;
     } else if (FLAGS_index_type == "glin") {
       config.index_type = IndexType::kGLIN;
+    } else if (FLAGS_index_type == "geos-prepared") {
+      config.index_type = IndexType::kGEOSPrepared;
+    } else if (FLAGS_index_type == "grid") {
+      config.index_type = IndexType::kGrid;
+    } else if (FLAGS_index_type == "grid-adaptive") {
+      config.index_type = IndexType::kGridAdaptive;
+    } else if (FLAGS_index_type == "quadtree") {
+      config.index_type = IndexType::kQuadTree;
     } else if (FLAGS_index_type == "lbvh") {
       config.index_type = IndexType::kLBVH;
+    } else if (FLAGS_index_type == "lbvh-cpu") {
+      config.index_type = IndexType::kLBVHCPU;
+    } else if (FLAGS_index_type == "pbsm") {
+      config.index_type = IndexType::kPBSM;
+    } else if (FLAGS_index_type == "sweep") {
+      config.index_type = IndexType::kSweep;
     } else {
       std::cerr << "Invalid index type " << FLAGS_index_type << std::endl;
       abort();
@@ -4,10 +4,20 @@ DEFINE_string(input, "", "path of data file in wkt format");
 DEFINE_string(output, "", "path of data file in wkt format");
 DEFINE_string(serialize, "", "a directory to store serialized wkt file");
 DEFINE_int32(min_qualified, -1, "Intersects per query");
-DEFINE_double(
-    selectivity, 0.01,
-    "Each query guarantees returning selectivity*cardinality geometries");
+DEFINE_double(selectivity, 0.01,
+              "Target fraction of the geometries a generated range-intersects "
+              "query returns, met within +/- selectivity_tolerance. A query "
+              "may return fewer, one that never reaches the band is emitted "
+              "at the extent closest to the target");
+DEFINE_double(selectivity_tolerance, 0.1,
+              "Relative tolerance on the number of geometries a generated "
+              "range-intersects query returns, unless -min_qualified is set. "
+              "Must not be negative");
 DEFINE_int32(num_queries, 100, "");
+DEFINE_string(workloads, "",
+              "Comma-separated query workloads to generate from one load of "
+              "-input, e.g. point-contains:100000,"
+              "range-intersects:0.001:10000, written under -output");
 // query
 DEFINE_string(geom, "", "path of geom file in wkt format");
 DEFINE_string(query, "", "path of query file in wkt format");
@@ -16,10 +26,36 @@ DEFINE_double(load_factor, 0.1,
 DEFINE_int32(warmup, 5, "Number of warmup rounds");
 DEFINE_int32(repeat, 5, "Number of repeated evaluations");
 DEFINE_int32(limit, -1, "Read first limit lines");
-DEFINE_string(query_type, "", "point-contains/range-contains/range-intersects");
+DEFINE_string(query_type, "",
+              "point-contains/range-contains/range-intersects, gen also "
+              "takes reorder");
 DEFINE_int32(seed, 0, "random seed");
 DEFINE_string(index_type, "", "rtree/rtree-parallel/glin/lbvh");
 DEFINE_int32(parallelism, -1, "#of cores for CPU baselines");
 DEFINE_bool(avg_time, true, "Report average time or list all times");
 DEFINE_int32(batch, -1, "Batch size of insertion/deletion");
-DEFINE_double(update_ratio, 0, "");
\ No newline at end of file
+DEFINE_double(update_ratio, 0, "");
+DEFINE_int32(glin_cell_bits, 26,
+             "Bits per axis of GLIN's curve grid, the grid spans the data");
+DEFINE_string(glin_piece_limit, "1000",
+              "Comma separated piece limitations of GLIN to sweep");
+DEFINE_string(reorder, "none",
+              "Sort the geometries before indexing: none/morton/hilbert/str");
+DEFINE_string(reorder_queries, "none",
+              "Sort queries before running them: none/morton/hilbert/str");
+DEFINE_int32(k, 1, "Number of neighbours of knn queries");
+DEFINE_bool(check, false,
+            "Check the results against a brute-force scan of sampled queries");
+DEFINE_double(distance, 0,
+              "Distance of within-distance queries, in units of the data");
+DEFINE_int32(pip_slab_threshold, 0,
+             "Polygons with at least this many vertices get an edge slab "
+             "index for CPU PIP refinement, 0 disables it");
+DEFINE_int32(pip_raster_resolution, 0,
+             "Cells per axis of the inside/outside/boundary raster of every "
+             "polygon for CPU PIP, 0 disables it");
+DEFINE_string(refine, "none",
+              "Refine range query candidates against the polygons: "
+              "none/exact/geos");
+DEFINE_bool(csr, false,
+            "Group the results by query into per-query offsets and geom ids");
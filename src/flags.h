@@ -8,6 +8,7 @@ DECLARE_string(output);
 DECLARE_string(serialize);
 DECLARE_int32(min_qualified);
 DECLARE_double(selectivity);
+DECLARE_double(selectivity_tolerance);
 DECLARE_string(geom);
 DECLARE_string(query);
 DECLARE_double(load_factor);
@@ -15,6 +16,7 @@ DECLARE_int32(warmup);
 DECLARE_int32(repeat);
 DECLARE_int32(limit);
 DECLARE_int32(num_queries);
+DECLARE_string(workloads);
 DECLARE_string(query_type);
 DECLARE_int32(seed);
 DECLARE_string(index_type);
@@ -22,4 +24,15 @@ DECLARE_int32(parallelism);
 DECLARE_bool(avg_time);
 DECLARE_int32(batch);
 DECLARE_double(update_ratio);
+DECLARE_int32(glin_cell_bits);
+DECLARE_string(glin_piece_limit);
+DECLARE_string(reorder);
+DECLARE_string(reorder_queries);
+DECLARE_int32(k);
+DECLARE_bool(check);
+DECLARE_double(distance);
+DECLARE_int32(pip_slab_threshold);
+DECLARE_int32(pip_raster_resolution);
+DECLARE_string(refine);
+DECLARE_bool(csr);
 #endif // SPATIALQUERYBENCHMARK_FLAGS_H
@@ -1,10 +1,16 @@
 #include <algorithm>
 #include <iostream>
 
+#include "benchmark_configs.h"
 #include "flags.h"
 #include "generator.h"
+#include "reorder.h"
+#include "stopwatch.h"
 #include "wkt_loader.h"
 
+#include <cctype>
+#include <sstream>
+
 template <typename GEOM_T>
 void DumpBoxes(const std::string &output, const std::vector<GEOM_T> &geoms) {
   std::ofstream ofs(output);
@@ -16,6 +22,133 @@ void DumpBoxes(const std::string &output, const std::vector<GEOM_T> &geoms) {
   ofs.close();
 }
 
+struct Workload {
+  std::string query_type;
+  size_t num_queries;
+  // range-intersects only
+  double selectivity = 0;
+  std::string output;
+};
+
+// A count is all digits, so "-1" does not wrap around
+bool ParseCount(const std::string &field, size_t &count) {
+  if (field.empty() ||
+      !std::all_of(field.begin(), field.end(),
+                   [](unsigned char c) { return std::isdigit(c); })) {
+    return false;
+  }
+  errno = 0;
+  count = std::strtoull(field.c_str(), nullptr, 10);
+  return errno == 0;
+}
+
+bool ParseSelectivity(const std::string &field, double &selectivity) {
+  char *end;
+
+  errno = 0;
+  selectivity = std::strtod(field.c_str(), &end);
+  return !field.empty() && *end == '\0' && errno == 0 && selectivity > 0 &&
+         selectivity <= 1;
+}
+
+/**
+ * Parses -workloads, comma-separated specs of the form point-contains:N,
+ * range-contains:N or range-intersects:SELECTIVITY:N. Each workload is written
+ * to <output_dir>/<query_type>[_select_SELECTIVITY]_queries_N/<input name>,
+ * the layout the experiment scripts read.
+ */
+std::vector<Workload> ParseWorkloads(const std::string &specs,
+                                     const std::string &output_dir,
+                                     const std::string &input) {
+  auto input_name = input.substr(input.find_last_of('/') + 1);
+  std::vector<Workload> workloads;
+  std::stringstream ss(specs);
+  std::string spec;
+
+  while (std::getline(ss, spec, ',')) {
+    std::vector<std::string> fields;
+    std::stringstream spec_ss(spec);
+    std::string field;
+    Workload w;
+
+    while (std::getline(spec_ss, field, ':')) {
+      fields.push_back(field);
+    }
+    if (fields.empty()) {
+      continue;
+    }
+    w.query_type = fields[0];
+
+    size_t expected_fields = w.query_type == "range-intersects" ? 3 : 2;
+
+    if ((w.query_type != "point-contains" &&
+         w.query_type != "range-contains" &&
+         w.query_type != "range-intersects") ||
+        fields.size() != expected_fields ||
+        !ParseCount(fields.back(), w.num_queries) ||
+        (expected_fields == 3 && !ParseSelectivity(fields[1], w.selectivity))) {
+      std::cerr << "Invalid workload " << spec << std::endl;
+      abort();
+    }
+    std::string dir = output_dir + "/" + w.query_type;
+
+    if (expected_fields == 3) {
+      // As written, so the path matches what the scripts ask for
+      dir += "_select_" + fields[1];
+    }
+    dir += "_queries_" + fields.back();
+    if (mkdir(dir.c_str(), 0755) && errno != EEXIST) {
+      std::cerr << "Cannot create dir " << dir << std::endl;
+      abort();
+    }
+    w.output = dir + "/" + input_name;
+    workloads.push_back(w);
+  }
+  return workloads;
+}
+
+/**
+ * Range-intersects queries are sized by the selectivity with the aggregate
+ * R-tree, built on first use, unless -min_qualified asks for the queries
+ * grown from nearest neighbours.
+ */
+void GenerateWorkload(const std::vector<box_t> &geoms,
+                      const gen_rtree_t &rtree, AggregateRTree &artree,
+                      const Workload &w, int min_qualified, int seed) {
+  if (w.query_type == "point-contains") {
+    auto queries = GeneratePointQueries(rtree, w.num_queries, seed);
+
+    DumpBoxes(w.output, queries);
+  } else if (w.query_type == "range-contains") {
+    auto queries = GenerateContainsQueries(rtree, w.num_queries, seed);
+
+    DumpBoxes(w.output, queries);
+  } else if (w.query_type == "range-intersects" && min_qualified == -1) {
+    if (artree.get_height() == 0) {
+      Stopwatch sw;
+
+      sw.start();
+      artree.Build(geoms);
+      sw.stop();
+      std::cout << "Aggregate R-tree Build Time " << sw.ms() << " ms"
+                << std::endl;
+    }
+    std::cout << "Selectivity " << w.selectivity << ", Tolerance "
+              << FLAGS_selectivity_tolerance << std::endl;
+    auto queries = GenerateSelectivityQueries(rtree, artree, w.selectivity,
+                                              FLAGS_selectivity_tolerance,
+                                              w.num_queries, seed);
+    DumpBoxes(w.output, queries);
+  } else if (w.query_type == "range-intersects") {
+    auto queries =
+        GenerateIntersectsQueries(rtree, min_qualified, w.num_queries, seed);
+    DumpBoxes(w.output, queries);
+  } else {
+    std::cerr << "Not supported query type: " << w.query_type << std::endl;
+    abort();
+  }
+}
+
 int main(int argc, char *argv[]) {
   gflags::SetUsageMessage("Usage: ");
   if (argc == 1) {
@@ -29,7 +162,7 @@ int main(int argc, char *argv[]) {
   std::string query_type = FLAGS_query_type;
   int limit = FLAGS_limit;
   int min_qualified = FLAGS_min_qualified;
-  float selectivity = FLAGS_selectivity;
+  double selectivity = FLAGS_selectivity;
   int num_queries = FLAGS_num_queries;
   int seed = FLAGS_seed;
 
@@ -42,30 +175,61 @@ int main(int argc, char *argv[]) {
     abort();
   }
 
+  if (FLAGS_selectivity_tolerance < 0) {
+    std::cerr << "Invalid selectivity tolerance "
+              << FLAGS_selectivity_tolerance << std::endl;
+    abort();
+  }
+
   auto polygons = LoadPolygons(FLAGS_input, FLAGS_serialize, limit);
+
+  // Writes the dataset itself in -reorder order, so later runs can load it
+  // pre-sorted instead of sorting on every run
+  if (query_type == "reorder") {
+    auto type = BenchmarkConfig::ParseReorderType("reorder", FLAGS_reorder);
+
+    Reorder(polygons, type, "Dataset");
+    DumpBoxes(output, polygons);
+    std::cout << "Wrote " << polygons.size() << " polygons to " << output
+              << std::endl;
+    gflags::ShutDownCommandLineFlags();
+    return 0;
+  }
+
   auto geoms = PolygonsToBoxes(polygons);
   std::cout << "Loaded geometries " << geoms.size() << std::endl;
 
-  if (query_type == "point-contains") {
-    auto queries = GeneratePointQueries(geoms, num_queries, seed);
+  // With -workloads, -output is the directory the query files go under
+  std::vector<Workload> workloads;
 
-    DumpBoxes(output, queries);
-  } else if (query_type == "range-contains") {
-    auto queries = GenerateContainsQueries(geoms, num_queries, seed);
+  if (FLAGS_workloads.empty()) {
+    Workload w;
 
-    DumpBoxes(output, queries);
-  } else if (query_type == "range-intersects") {
-    if (min_qualified == -1) {
-      min_qualified = std::max(1ul, (size_t)(geoms.size() * selectivity));
-      std::cout << "Selectivity " << selectivity << ", Min qualified per query "
-                << min_qualified << std::endl;
-    }
-    auto queries =
-        GenerateIntersectsQueries(geoms, min_qualified, num_queries, seed);
-    DumpBoxes(output, queries);
+    w.query_type = query_type;
+    w.num_queries = num_queries;
+    w.selectivity = selectivity;
+    w.output = output;
+    workloads.push_back(w);
   } else {
-    std::cerr << "Not supported query type: " << FLAGS_query_type << std::endl;
-    abort();
+    workloads = ParseWorkloads(FLAGS_workloads, output, input);
+  }
+
+  Stopwatch sw;
+
+  sw.start();
+  gen_rtree_t rtree(geoms);
+  sw.stop();
+  std::cout << "Build Time " << sw.ms() << " ms" << std::endl;
+
+  AggregateRTree artree;
+
+  for (auto &w : workloads) {
+    sw.start();
+    GenerateWorkload(geoms, rtree, artree, w, min_qualified, seed);
+    sw.stop();
+    std::cout << "Generated " << w.num_queries << " " << w.query_type
+              << " queries to " << w.output << " in " << sw.ms() << " ms"
+              << std::endl;
   }
 
   gflags::ShutDownCommandLineFlags();
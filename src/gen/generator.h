@@ -2,10 +2,12 @@
 #define SPATIALQUERYBENCHMARK_GENERATOR_H
 #include <boost/geometry/index/rtree.hpp>
 #include <boost/iterator/function_output_iterator.hpp>
-#include <random>
-#include <thread>
+#include <atomic>
 
+#include "gen/philox.h"
 #include "geom_common.h"
+#include "query/artree/artree.h"
+#include "parlay/primitives.h"
 
 box_t get_bounds(const std::vector<box_t> &data) {
   auto min_x = std::numeric_limits<coord_t>::max();
@@ -22,6 +24,23 @@ box_t get_bounds(const std::vector<box_t> &data) {
   return box_t(point_t(min_x, min_y), point_t(max_x, max_y));
 }
 
+/**
+ * The index every generator queries, built once per dataset and shared by all
+ * the workloads generated from it.
+ */
+using gen_rtree_t =
+    boost::geometry::index::rtree<box_t, boost::geometry::index::rstar<16>,
+                                  boost::geometry::index::indexable<box_t>>;
+
+/**
+ * Every query draws from its own Philox stream keyed on (seed, query index),
+ * so the queries are generated in parallel and are the same for a seed
+ * whatever the number of threads.
+ */
+inline Philox QueryRNG(int seed, size_t query_id) {
+  return Philox((uint32_t)seed, query_id);
+}
+
 /**
  * Generate the queries that there are at least num_qualified input rectangles
  * contain a query
@@ -31,38 +50,28 @@ box_t get_bounds(const std::vector<box_t> &data) {
  * @param seed
  * @return
  */
-std::vector<point_t> GeneratePointQueries(const std::vector<box_t> &data,
+std::vector<point_t> GeneratePointQueries(const gen_rtree_t &rtree,
                                           size_t num_queries, int seed = 0) {
-  boost::geometry::index::rtree<box_t, boost::geometry::index::rstar<16>,
-                                boost::geometry::index::indexable<box_t>>
-      rtree(data);
   auto min_point = rtree.bounds().min_corner();
   auto max_point = rtree.bounds().max_corner();
-  std::mt19937 mt(seed);
-  std::uniform_real_distribution<double> dist_x(min_point.get<0>(),
-                                                max_point.get<0>());
-  std::uniform_real_distribution<double> dist_y(min_point.get<1>(),
-                                                max_point.get<1>());
-  std::vector<point_t> queries;
 
-  for (size_t i = 0; i < num_queries; i++) {
-    double x = dist_x(mt);
-    double y = dist_y(mt);
+  auto queries = parlay::tabulate(num_queries, [&](size_t i) {
+    auto rng = QueryRNG(seed, i);
+    double x = rng.Uniform(min_point.get<0>(), max_point.get<0>());
+    double y = rng.Uniform(min_point.get<1>(), max_point.get<1>());
     point_t p(x, y);
+    point_t point_in_box;
 
     rtree.query(boost::geometry::index::nearest(p, 1),
                 boost::make_function_output_iterator([&](const box_t &b) {
-                  std::uniform_real_distribution<double> dist_box_x(
-                      b.min_corner().x(), b.max_corner().x());
-                  std::uniform_real_distribution<double> dist_box_y(
-                      b.min_corner().y(), b.max_corner().y());
-
-                  point_t point_in_box(dist_box_x(mt), dist_box_y(mt));
-                  queries.push_back(point_in_box);
+                  point_in_box = point_t(
+                      rng.Uniform(b.min_corner().x(), b.max_corner().x()),
+                      rng.Uniform(b.min_corner().y(), b.max_corner().y()));
                 }));
-  }
+    return point_in_box;
+  });
 
-  return queries;
+  return {queries.begin(), queries.end()};
 }
 
 /**
@@ -74,49 +83,33 @@ std::vector<point_t> GeneratePointQueries(const std::vector<box_t> &data,
  * @param seed
  * @return
  */
-std::vector<box_t> GenerateContainsQueries(const std::vector<box_t> &data,
+std::vector<box_t> GenerateContainsQueries(const gen_rtree_t &rtree,
                                            size_t num_queries, int seed = 0) {
-  boost::geometry::index::rtree<box_t, boost::geometry::index::rstar<16>,
-                                boost::geometry::index::indexable<box_t>>
-      rtree(data);
   auto min_point = rtree.bounds().min_corner();
   auto max_point = rtree.bounds().max_corner();
-  std::mt19937 mt(seed);
-  std::uniform_real_distribution<double> dist_x(min_point.get<0>(),
-                                                max_point.get<0>());
-  std::uniform_real_distribution<double> dist_y(min_point.get<1>(),
-                                                max_point.get<1>());
-  std::vector<box_t> queries;
 
-  for (size_t i = 0; i < num_queries; i++) {
-    double x = dist_x(mt);
-    double y = dist_y(mt);
+  auto queries = parlay::tabulate(num_queries, [&](size_t i) {
+    auto rng = QueryRNG(seed, i);
+    double x = rng.Uniform(min_point.get<0>(), max_point.get<0>());
+    double y = rng.Uniform(min_point.get<1>(), max_point.get<1>());
     point_t p(x, y);
+    box_t query;
 
     rtree.query(boost::geometry::index::nearest(p, 1),
                 boost::make_function_output_iterator([&](const box_t &b) {
-                  auto width = b.max_corner().x() - b.min_corner().x();
-                  auto height = b.max_corner().y() - b.min_corner().y();
-
-                  std::uniform_real_distribution<double> dist_min_x(
-                      b.min_corner().x(), b.max_corner().x());
-                  std::uniform_real_distribution<double> dist_min_y(
-                      b.min_corner().y(), b.max_corner().y());
-                  auto min_x = dist_min_x(mt);
-                  auto min_y = dist_min_y(mt);
-                  std::uniform_real_distribution<double> dist_max_x(
-                      min_x, b.max_corner().x());
-                  std::uniform_real_distribution<double> dist_max_y(
-                      min_y, b.max_corner().y());
-                  auto max_x = dist_max_x(mt);
-                  auto max_y = dist_max_y(mt);
-                  box_t query(point_t(min_x, min_y), point_t(max_x, max_y));
-
-                  queries.push_back(query);
+                  auto min_x =
+                      rng.Uniform(b.min_corner().x(), b.max_corner().x());
+                  auto min_y =
+                      rng.Uniform(b.min_corner().y(), b.max_corner().y());
+                  auto max_x = rng.Uniform(min_x, b.max_corner().x());
+                  auto max_y = rng.Uniform(min_y, b.max_corner().y());
+
+                  query = box_t(point_t(min_x, min_y), point_t(max_x, max_y));
                 }));
-  }
+    return query;
+  });
 
-  return queries;
+  return {queries.begin(), queries.end()};
 }
 
 /**
@@ -128,154 +121,217 @@ std::vector<box_t> GenerateContainsQueries(const std::vector<box_t> &data,
  * @param seed
  * @return
  */
-std::vector<box_t> GenerateIntersectsQueries(const std::vector<box_t> &data,
+std::vector<box_t> GenerateIntersectsQueries(const gen_rtree_t &rtree,
                                              size_t min_qualified,
                                              size_t num_queries, int seed = 0) {
-  boost::geometry::index::rtree<box_t,
-                                boost::geometry::index::linear<BOOST_LEAF_SIZE>,
-                                boost::geometry::index::indexable<box_t>>
-      rtree(data);
-  auto bounds = get_bounds(data);
+  box_t bounds;
+
+  boost::geometry::convert(rtree.bounds(), bounds);
 
   printf("range x [%f, %f], y [%f, %f]\n", bounds.min_corner().x(),
          bounds.max_corner().x(), bounds.min_corner().y(),
          bounds.max_corner().y());
 
-  std::mt19937 mt(seed);
-  std::vector<box_t> queries;
   std::atomic_uint64_t total_intersects = 0;
 
-  auto n_threads = std::thread::hardware_concurrency();
-  auto avg_queries = (num_queries + n_threads - 1) / n_threads;
-  std::vector<std::thread> threads;
-  std::mutex mu;
-
-  for (uint32_t tid = 0; tid < n_threads; tid++) {
-    threads.emplace_back(
-        [&](int tid) {
-          std::uniform_real_distribution<coord_t> dist_x(
-              bounds.min_corner().x(), bounds.max_corner().x());
-          std::uniform_real_distribution<coord_t> dist_y(
-              bounds.min_corner().y(), bounds.max_corner().y());
-          auto begin = std::min(tid * avg_queries, num_queries);
-          auto end = std::min(begin + avg_queries, num_queries);
-          std::vector<box_t> local_queries;
-
-          for (auto i = begin; i < end; i++) {
-          retry:
-            auto x = dist_x(mt);
-            auto y = dist_y(mt);
-            point_t p(x, y);
-            auto min_x = x;
-            auto min_y = y;
-            auto max_x = x;
-            auto max_y = y;
-
-            std::vector<box_t> results;
-
-            rtree.query(boost::geometry::index::nearest(p, min_qualified),
-                        std::back_inserter(results));
-            box_t query;
-
-            for (const box_t &nbr_box : results) {
-              min_x = std::min(min_x, nbr_box.min_corner().x());
-              min_y = std::min(min_y, nbr_box.min_corner().y());
-              max_x = std::max(max_x, nbr_box.max_corner().x());
-              max_y = std::max(max_y, nbr_box.max_corner().y());
-              query = box_t(point_t(min_x, min_y), point_t(max_x, max_y));
-              uint32_t n_intersects = 0;
-
-              rtree.query(boost::geometry::index::intersects(query),
-                          boost::make_function_output_iterator(
-                              [&](const box_t &b) { n_intersects++; }));
-              if (n_intersects >= min_qualified) {
-                // too many intersections, retry to generate another query
-                if (min_qualified > 1 &&
-                    (float)n_intersects / min_qualified > 10) {
-                  goto retry;
-                }
-                total_intersects += n_intersects;
-                break;
-              }
-            }
-
-            local_queries.push_back(query);
-          }
-
-          std::unique_lock<std::mutex> lock(mu);
-          queries.insert(queries.end(), local_queries.begin(),
-                         local_queries.end());
-        },
-        tid);
-  }
-  for (auto &thread : threads) {
-    thread.join();
-  }
-
-  std::cout << "Real selectivity "
-            << (float)total_intersects / (data.size() * num_queries)
-            << std::endl;
-
-  return queries;
-}
-
-std::vector<box_t> GenerateUniformQueries(const std::vector<box_t> &data,
-                                          float fraction, size_t num_queries,
-                                          int seed = 0) {
-  boost::geometry::index::rtree<box_t, boost::geometry::index::rstar<16>,
-                                boost::geometry::index::indexable<box_t>>
-      rtree(data);
-  auto min_point = rtree.bounds().min_corner();
-  auto max_point = rtree.bounds().max_corner();
-  std::mt19937 mt(seed);
-  std::uniform_real_distribution<coord_t> dist_x(min_point.get<0>(),
-                                                 max_point.get<0>());
-  std::uniform_real_distribution<coord_t> dist_y(min_point.get<1>(),
-                                                 max_point.get<1>());
-  std::vector<box_t> queries;
-
-  coord_t width = max_point.get<0>() - min_point.get<0>();
-  coord_t height = max_point.get<1>() - min_point.get<1>();
-
-  coord_t width_frac = width * sqrt(fraction);
-  coord_t height_frac = height * sqrt(fraction);
+  auto queries = parlay::tabulate(num_queries, [&](size_t i) {
+    auto rng = QueryRNG(seed, i);
+    std::vector<box_t> results;
+    box_t query;
 
-  for (size_t i = 0; i < num_queries; i++) {
-    auto x = dist_x(mt);
-    auto y = dist_y(mt);
+  retry:
+    auto x = rng.Uniform(bounds.min_corner().x(), bounds.max_corner().x());
+    auto y = rng.Uniform(bounds.min_corner().y(), bounds.max_corner().y());
     point_t p(x, y);
     auto min_x = x;
     auto min_y = y;
+    auto max_x = x;
+    auto max_y = y;
+
+    results.clear();
+    rtree.query(boost::geometry::index::nearest(p, min_qualified),
+                std::back_inserter(results));
+
+    for (const box_t &nbr_box : results) {
+      min_x = std::min(min_x, (double)nbr_box.min_corner().x());
+      min_y = std::min(min_y, (double)nbr_box.min_corner().y());
+      max_x = std::max(max_x, (double)nbr_box.max_corner().x());
+      max_y = std::max(max_y, (double)nbr_box.max_corner().y());
+      query = box_t(point_t(min_x, min_y), point_t(max_x, max_y));
+      uint32_t n_intersects = 0;
+
+      rtree.query(boost::geometry::index::intersects(query),
+                  boost::make_function_output_iterator(
+                      [&](const box_t &b) { n_intersects++; }));
+      if (n_intersects >= min_qualified) {
+        // too many intersections, retry to generate another query
+        if (min_qualified > 1 && (float)n_intersects / min_qualified > 10) {
+          goto retry;
+        }
+        total_intersects += n_intersects;
+        break;
+      }
+    }
+    return query;
+  });
 
-    float max_x;
-    float max_y;
-
-    do {
-      max_x = x + width_frac;
-      max_y = y + height_frac;
-      x = dist_x(mt);
-      y = dist_y(mt);
-    } while (max_x > max_point.get<0>() || max_y > max_point.get<1>());
+  std::cout << "Real selectivity "
+            << (float)total_intersects / (rtree.size() * num_queries)
+            << std::endl;
 
-    box_t query(point_t(min_x, min_y), point_t(max_x, max_y));
+  return {queries.begin(), queries.end()};
+}
 
-    //    size_t result_size = 0;
-    //
-    //    rtree.query(boost::geometry::index::intersects(query),
-    //                boost::make_function_output_iterator(
-    //                    [&](const box_t &b) { result_size++; }));
+/**
+ * Generate the queries that each intersects about selectivity of the input
+ * rectangles, within a relative tolerance. A query is centred in a rectangle
+ * near a uniform point, like the point queries, and its extent, proportional
+ * to the bounds of the data, is found by a search on the number of rectangles
+ * it intersects: doubling or halving until the target is bracketed, then
+ * bisecting. The counts come from the aggregate R-tree without listing the
+ * rectangles. A query whose count cannot reach the band, e.g. when its centre
+ * alone lies in too many rectangles, keeps the extent closest to the target.
+ * @param rtree
+ * @param artree the same rectangles, for counting
+ * @param selectivity
+ * @param tolerance
+ * @param num_queries
+ * @param seed
+ * @return
+ */
+std::vector<box_t> GenerateSelectivityQueries(const gen_rtree_t &rtree,
+                                              const AggregateRTree &artree,
+                                              double selectivity,
+                                              double tolerance,
+                                              size_t num_queries,
+                                              int seed = 0) {
+  constexpr int kMaxSteps = 64;
+  auto n = rtree.size();
+  double target = std::max(1.0, selectivity * n);
+  auto band_lo = (size_t)std::max(1.0, std::ceil(target * (1 - tolerance)));
+  auto band_hi = std::max(band_lo, (size_t)(target * (1 + tolerance)));
+  box_t bounds;
+
+  boost::geometry::convert(rtree.bounds(), bounds);
+
+  double width = bounds.max_corner().x() - bounds.min_corner().x();
+  double height = bounds.max_corner().y() - bounds.min_corner().y();
+  std::vector<std::vector<uint32_t>> buffers(parlay::num_workers());
+  std::vector<size_t> counts(num_queries);
+  std::vector<int> steps(num_queries);
+
+  auto queries = parlay::tabulate(num_queries, [&](size_t i) {
+    auto rng = QueryRNG(seed, i);
+    auto &buffer = buffers[parlay::worker_id()];
+    point_t p(rng.Uniform(bounds.min_corner().x(), bounds.max_corner().x()),
+              rng.Uniform(bounds.min_corner().y(), bounds.max_corner().y()));
+    point_t centre;
 
-    //    if(result_size > 1000) {
-    //      std::cout << "intersects " << result_size << std::endl;
-    //    }
+    rtree.query(boost::geometry::index::nearest(p, 1),
+                boost::make_function_output_iterator([&](const box_t &b) {
+                  centre = point_t(
+                      rng.Uniform(b.min_corner().x(), b.max_corner().x()),
+                      rng.Uniform(b.min_corner().y(), b.max_corner().y()));
+                }));
 
-    //    std::cout << "Result frac " << (float)result_size / data.size()
-    //              << std::endl;
+    auto window = [&](double r) {
+      return box_t(point_t(centre.x() - r * width, centre.y() - r * height),
+                   point_t(centre.x() + r * width, centre.y() + r * height));
+    };
+    // Half extents, as fractions of the bounds. At r = 1 the window covers
+    // the bounds from any centre, so the count there is n.
+    double lo = 0, hi = 1;
+    bool lo_found = false, hi_found = false;
+    // The extent if the rectangles were spread uniformly
+    double r = std::min(1.0, std::sqrt(selectivity) / 2);
+    double best_r = r;
+    size_t best_count = 0;
+    double best_error = std::numeric_limits<double>::max();
+    int step = 0;
+
+    while (step < kMaxSteps) {
+      auto count = artree.CountIntersects(window(r), buffer);
+      double error = std::abs((double)count - target);
+
+      step++;
+      if (error < best_error) {
+        best_r = r;
+        best_count = count;
+        best_error = error;
+      }
+      if (count >= band_lo && count <= band_hi) {
+        break;
+      }
+      if (count < band_lo) {
+        lo = r;
+        lo_found = true;
+        r = hi_found ? (lo + hi) / 2 : std::min(1.0, r * 2);
+      } else {
+        hi = r;
+        hi_found = true;
+        r = lo_found ? (lo + hi) / 2 : r / 2;
+      }
+    }
+    counts[i] = best_count;
+    steps[i] = step;
+    return window(best_r);
+  });
+
+  std::vector<double> achieved(num_queries);
+  size_t in_band = 0, total_steps = 0;
 
-    queries.push_back(query);
+  for (size_t i = 0; i < num_queries; i++) {
+    achieved[i] = (double)counts[i] / n;
+    in_band += counts[i] >= band_lo && counts[i] <= band_hi;
+    total_steps += steps[i];
+  }
+  std::sort(achieved.begin(), achieved.end());
+
+  auto percentile = [&](double p) {
+    return achieved[std::min(num_queries - 1, (size_t)(p * num_queries))];
+  };
+
+  if (num_queries > 0) {
+    std::cout << "Achieved selectivity min " << achieved.front() << " p5 "
+              << percentile(0.05) << " p50 " << percentile(0.5) << " p95 "
+              << percentile(0.95) << " max " << achieved.back() << std::endl;
+    std::cout << "Within tolerance " << 100.0 * in_band / num_queries
+              << "%, Counts per query " << (double)total_steps / num_queries
+              << std::endl;
   }
 
-  return queries;
+  return {queries.begin(), queries.end()};
+}
+
+/**
+ * Generate square-shaped queries covering fraction of the bounds each, placed
+ * uniformly so that they lie within the bounds
+ */
+std::vector<box_t> GenerateUniformQueries(const gen_rtree_t &rtree,
+                                          float fraction, size_t num_queries,
+                                          int seed = 0) {
+  box_t bounds;
+
+  boost::geometry::convert(rtree.bounds(), bounds);
+  auto min_point = bounds.min_corner();
+  auto max_point = bounds.max_corner();
+  double width = max_point.get<0>() - min_point.get<0>();
+  double height = max_point.get<1>() - min_point.get<1>();
+  double width_frac = width * sqrt(fraction);
+  double height_frac = height * sqrt(fraction);
+
+  auto queries = parlay::tabulate(num_queries, [&](size_t i) {
+    auto rng = QueryRNG(seed, i);
+    auto min_x =
+        rng.Uniform(min_point.get<0>(), max_point.get<0>() - width_frac);
+    auto min_y =
+        rng.Uniform(min_point.get<1>(), max_point.get<1>() - height_frac);
+
+    return box_t(point_t(min_x, min_y),
+                 point_t(min_x + width_frac, min_y + height_frac));
+  });
+
+  return {queries.begin(), queries.end()};
 }
 
 #endif // SPATIALQUERYBENCHMARK_GENERATOR_H
@@ -0,0 +1,86 @@
+#ifndef SPATIALQUERYBENCHMARK_PHILOX_H
+#define SPATIALQUERYBENCHMARK_PHILOX_H
+#include <cstdint>
+#include <limits>
+
+/**
+ * Philox4x32-10 from "Parallel Random Numbers: As Easy as 1, 2, 3" (Salmon et
+ * al., SC'11). Each number is a pure function of (key, counter), so a stream
+ * keyed on (seed, query index) gives every query the same numbers whichever
+ * thread generates it and in whatever order. Satisfies
+ * UniformRandomBitGenerator, but Uniform should be preferred, the standard
+ * distributions differ between library implementations.
+ */
+class Philox {
+  static constexpr uint32_t kMul0 = 0xD2511F53;
+  static constexpr uint32_t kMul1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+  static constexpr int kRounds = 10;
+
+public:
+  using result_type = uint32_t;
+
+  Philox(uint64_t seed, uint64_t stream)
+      : key_{(uint32_t)seed, (uint32_t)(seed >> 32)},
+        counter_{0, 0, (uint32_t)stream, (uint32_t)(stream >> 32)} {}
+
+  static constexpr result_type min() { return 0; }
+
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    if (next_ == 4) {
+      Generate(counter_, key_, block_);
+      // The low 64 bits count the blocks of the stream
+      if (++counter_[0] == 0) {
+        ++counter_[1];
+      }
+      next_ = 0;
+    }
+    return block_[next_++];
+  }
+
+  // Uniform in [0, 1) with 53 random bits
+  double NextDouble() {
+    uint64_t hi = (*this)() >> 5, lo = (*this)() >> 6;
+
+    return (hi * 67108864.0 + lo) / 9007199254740992.0;
+  }
+
+  // Uniform in [a, b)
+  double Uniform(double a, double b) { return a + (b - a) * NextDouble(); }
+
+  static void Generate(const uint32_t (&counter)[4], const uint32_t (&key)[2],
+                       uint32_t (&out)[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2],
+             c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int r = 0; r < kRounds; r++) {
+      uint64_t p0 = (uint64_t)kMul0 * c0;
+      uint64_t p1 = (uint64_t)kMul1 * c2;
+
+      c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+      c1 = (uint32_t)p1;
+      c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+      c3 = (uint32_t)p0;
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+private:
+  uint32_t key_[2];
+  uint32_t counter_[4];
+  uint32_t block_[4];
+  int next_ = 4;
+};
+
+#endif // SPATIALQUERYBENCHMARK_PHILOX_H
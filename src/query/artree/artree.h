@@ -0,0 +1,210 @@
+#ifndef SPATIALQUERYBENCHMARK_ARTREE_ARTREE_H
+#define SPATIALQUERYBENCHMARK_ARTREE_ARTREE_H
+#include "geom_common.h"
+#include "reorder.h"
+#include "simd.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * A packed aggregate R-tree that counts boxes instead of listing them. Every
+ * level is packed with STR: the nodes of the level below are sorted into STR
+ * order and cut into runs of kFanout, and each run becomes one parent. Nodes
+ * store their MBR and the number of boxes below them, so a node inside the
+ * window adds its count without visiting its subtree. Levels are SoA arrays
+ * and the children of a node are contiguous, so the boxes under a leaf node
+ * are counted with one SIMD pass.
+ */
+class AggregateRTree {
+  static constexpr size_t kFanout = 16;
+
+public:
+  void Build(const std::vector<box_t> &boxes) {
+    Clear();
+    if (boxes.empty()) {
+      return;
+    }
+
+    std::vector<box_t> level_boxes(boxes);
+    std::vector<uint32_t> counts(boxes.size(), 1);
+    std::vector<uint32_t> children; // empty for the boxes themselves
+
+    while (true) {
+      auto order = SpatialOrder(level_boxes,
+                                BenchmarkConfig::ReorderType::kSTR, kFanout);
+
+      Permute(level_boxes, order);
+      Permute(counts, order);
+      if (!children.empty()) {
+        Permute(children, order);
+      }
+      levels_.emplace_back();
+      levels_.back().Assign(level_boxes, counts, children);
+
+      if (level_boxes.size() == 1) {
+        break;
+      }
+
+      size_t n_parents = (level_boxes.size() + kFanout - 1) / kFanout;
+      std::vector<box_t> parent_boxes(n_parents);
+      std::vector<uint32_t> parent_counts(n_parents);
+
+      parlay::parallel_for(0, n_parents, [&](size_t i) {
+        auto begin = i * kFanout;
+        auto end = std::min(begin + kFanout, level_boxes.size());
+        box_t mbr;
+        uint32_t count = 0;
+
+        boost::geometry::assign_inverse(mbr);
+        for (auto j = begin; j < end; j++) {
+          boost::geometry::expand(mbr, level_boxes[j]);
+          count += counts[j];
+        }
+        parent_boxes[i] = mbr;
+        parent_counts[i] = count;
+      });
+
+      children.resize(n_parents);
+      for (size_t i = 0; i < n_parents; i++) {
+        children[i] = i * kFanout;
+      }
+      level_boxes = std::move(parent_boxes);
+      counts = std::move(parent_counts);
+    }
+  }
+
+  void Clear() { levels_.clear(); }
+
+  /**
+   * Number of boxes intersecting q. buffer is scratch space of the SIMD
+   * filter, kept by the caller to reuse across queries.
+   */
+  size_t CountIntersects(const box_t &q, std::vector<uint32_t> &buffer) const {
+    return Count<false>(q, buffer);
+  }
+
+  /**
+   * Number of boxes inside q, the same walk as CountIntersects but a box or
+   * node only partly inside the window adds nothing.
+   */
+  size_t CountContained(const box_t &q, std::vector<uint32_t> &buffer) const {
+    return Count<true>(q, buffer);
+  }
+
+  size_t get_height() const { return levels_.size(); }
+
+  size_t get_num_nodes() const {
+    size_t n = 0;
+
+    for (size_t i = 1; i < levels_.size(); i++) {
+      n += levels_[i].count.size();
+    }
+    return n;
+  }
+
+  size_t get_memory_bytes() const {
+    size_t bytes = 0;
+
+    for (auto &level : levels_) {
+      bytes += level.count.size() * (4 * sizeof(coord_t) + sizeof(uint32_t)) +
+               level.children.size() * sizeof(uint32_t);
+    }
+    return bytes;
+  }
+
+private:
+  template <bool kContained>
+  size_t Count(const box_t &q, std::vector<uint32_t> &buffer) const {
+    if (levels_.empty()) {
+      return 0;
+    }
+    if (buffer.size() < kFanout) {
+      buffer.resize(kFanout);
+    }
+    coord_t q_xmin = q.min_corner().x(), q_ymin = q.min_corner().y();
+    coord_t q_xmax = q.max_corner().x(), q_ymax = q.max_corner().y();
+    // (level, node), the tree height is logarithmic so the stack stays small
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    size_t count = 0;
+
+    stack.emplace_back(levels_.size() - 1, 0);
+    while (!stack.empty()) {
+      auto level_id = stack.back().first;
+      auto node = stack.back().second;
+      auto &level = levels_[level_id];
+
+      stack.pop_back();
+      if (level.xmin[node] > q_xmax || level.xmax[node] < q_xmin ||
+          level.ymin[node] > q_ymax || level.ymax[node] < q_ymin) {
+        continue;
+      }
+      if (level.xmin[node] >= q_xmin && level.xmax[node] <= q_xmax &&
+          level.ymin[node] >= q_ymin && level.ymax[node] <= q_ymax) {
+        count += level.count[node];
+        continue;
+      }
+      if (level_id == 0) {
+        count += !kContained; // A box overlapping the window
+        continue;
+      }
+
+      auto &child_level = levels_[level_id - 1];
+      auto begin = level.children[node];
+      auto end = std::min(begin + (uint32_t)kFanout,
+                          (uint32_t)child_level.count.size());
+
+      if (level_id == 1) {
+        // The children are boxes, counted without their ids
+        if constexpr (kContained) {
+          count += simd::FilterWithin(
+              child_level.xmin.data() + begin, child_level.ymin.data() + begin,
+              child_level.xmax.data() + begin, child_level.ymax.data() + begin,
+              end - begin, q_xmin, q_ymin, q_xmax, q_ymax, buffer.data());
+        } else {
+          count += simd::FilterIntersects(
+              child_level.xmin.data() + begin, child_level.ymin.data() + begin,
+              child_level.xmax.data() + begin, child_level.ymax.data() + begin,
+              end - begin, q_xmin, q_ymin, q_xmax, q_ymax, buffer.data());
+        }
+        continue;
+      }
+      for (auto child = begin; child < end; child++) {
+        stack.emplace_back(level_id - 1, child);
+      }
+    }
+    return count;
+  }
+
+  struct Level {
+    std::vector<coord_t> xmin, ymin, xmax, ymax;
+    std::vector<uint32_t> count;
+    // First child in the level below. Children come in runs of kFanout, only
+    // the run at the end of the level below can be shorter. Empty for boxes.
+    std::vector<uint32_t> children;
+
+    void Assign(const std::vector<box_t> &boxes,
+                const std::vector<uint32_t> &counts,
+                const std::vector<uint32_t> &first_children) {
+      xmin.resize(boxes.size());
+      ymin.resize(boxes.size());
+      xmax.resize(boxes.size());
+      ymax.resize(boxes.size());
+      parlay::parallel_for(0, boxes.size(), [&](size_t i) {
+        xmin[i] = boxes[i].min_corner().x();
+        ymin[i] = boxes[i].min_corner().y();
+        xmax[i] = boxes[i].max_corner().x();
+        ymax[i] = boxes[i].max_corner().y();
+      });
+      count = counts;
+      children = first_children;
+    }
+  };
+
+  // levels_[0] holds the boxes, the root is the only node of the last level
+  std::vector<Level> levels_;
+};
+
+#endif // SPATIALQUERYBENCHMARK_ARTREE_ARTREE_H
@@ -0,0 +1,72 @@
+#ifndef SPATIALQUERYBENCHMARK_ARTREE_RANGE_COUNT_QUERY_H
+#define SPATIALQUERYBENCHMARK_ARTREE_RANGE_COUNT_QUERY_H
+#include "query/artree/artree.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+#include <atomic>
+#include <thread>
+
+/**
+ * Counts the boxes intersecting each query, or with range-count-contained the
+ * boxes inside it.
+ */
+time_stat RunRangeCountQueryARTree(const std::vector<box_t> &boxes,
+                                   const std::vector<box_t> &queries,
+                                   const BenchmarkConfig &config) {
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  AggregateRTree tree;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    tree.Build(boxes);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  std::cout << "ARTree Height " << tree.get_height() << " Nodes "
+            << tree.get_num_nodes() << " Memory "
+            << tree.get_memory_bytes() / 1024.0 / 1024 << " MB" << std::endl;
+
+  bool contained =
+      config.query_type == BenchmarkConfig::QueryType::kRangeCountContained;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    size_t avg_queries =
+        (ts.num_queries + config.parallelism - 1) / config.parallelism;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> num_results{0};
+
+    sw.start();
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_queries, ts.num_queries);
+            auto end = std::min(begin + avg_queries, ts.num_queries);
+            std::vector<uint32_t> buffer;
+            size_t local_count = 0;
+
+            for (auto i = begin; i < end; i++) {
+              local_count += contained
+                                 ? tree.CountContained(queries[i], buffer)
+                                 : tree.CountIntersects(queries[i], buffer);
+            }
+            num_results += local_count;
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = num_results;
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_ARTREE_RANGE_COUNT_QUERY_H
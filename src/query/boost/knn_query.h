@@ -0,0 +1,91 @@
+#ifndef SPATIALQUERYBENCHMARK_BOOST_KNN_QUERY_H
+#define SPATIALQUERYBENCHMARK_BOOST_KNN_QUERY_H
+#include "stopwatch.h"
+#include "time_stat.h"
+#include "wkt_loader.h"
+#include <boost/iterator/function_output_iterator.hpp>
+#include <mutex>
+#include <thread>
+
+time_stat RunKNNQueryBoost(const std::vector<box_t> &boxes,
+                           const std::vector<point_t> &queries,
+                           const BenchmarkConfig &config) {
+  // Ids are stored next to the boxes, the results refer to them
+  using value_t = std::pair<box_t, uint32_t>;
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  boost::geometry::index::rtree<value_t,
+                                boost::geometry::index::linear<BOOST_LEAF_SIZE>>
+      rtree;
+  std::vector<value_t> values;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::mutex mu;
+
+  values.reserve(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++) {
+    values.emplace_back(boxes[i], i);
+  }
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    rtree.clear();
+    sw.start();
+    rtree.insert(values);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  ts.query_latency_us.resize(queries.size());
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    std::vector<std::thread> threads;
+    size_t avg_queries =
+        (ts.num_queries + config.parallelism - 1) / config.parallelism;
+
+    sw.start();
+    ts.num_results = 0;
+    results.clear();
+
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_queries, ts.num_queries);
+            auto end = std::min(begin + avg_queries, ts.num_queries);
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
+            Stopwatch query_sw;
+
+            for (auto i = begin; i < end; i++) {
+              auto &p = queries[i];
+
+              query_sw.start();
+              rtree.query(boost::geometry::index::nearest(p, config.k),
+                          boost::make_function_output_iterator(
+                              [&](const value_t &value) {
+                                local_results.emplace_back(value.second, i);
+                              }));
+              query_sw.stop();
+              ts.query_latency_us[i] = query_sw.us();
+            }
+
+            std::unique_lock<std::mutex> lock(mu);
+            results.insert(results.end(), local_results.begin(),
+                           local_results.end());
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  ts.results = std::move(results);
+  return ts;
+}
+
+#endif // SPATIALQUERYBENCHMARK_BOOST_KNN_QUERY_H
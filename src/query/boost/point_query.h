@@ -10,24 +10,30 @@
 time_stat RunPointQueryBoost(const std::vector<box_t> &boxes,
                              const std::vector<point_t> &queries,
                              const BenchmarkConfig &config) {
+  // Ids are stored next to the boxes, the results refer to them
+  using value_t = std::pair<box_t, uint32_t>;
   Stopwatch sw;
   time_stat ts;
 
   ts.num_geoms = boxes.size();
   ts.num_queries = queries.size();
 
-  boost::geometry::index::rtree<box_t,
-                                boost::geometry::index::linear<BOOST_LEAF_SIZE>,
-                                boost::geometry::index::indexable<box_t>>
+  boost::geometry::index::rtree<value_t,
+                                boost::geometry::index::linear<BOOST_LEAF_SIZE>>
       rtree;
-
-  std::vector<box_t> results;
+  std::vector<value_t> values;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
   std::mutex mu;
 
+  values.reserve(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++) {
+    values.emplace_back(boxes[i], i);
+  }
+
   for (int i = 0; i < config.warmup + config.repeat; i++) {
     rtree.clear();
     sw.start();
-    rtree.insert(boxes);
+    rtree.insert(values);
     sw.stop();
     ts.insert_ms.push_back(sw.ms());
   }
@@ -46,13 +52,16 @@ time_stat RunPointQueryBoost(const std::vector<box_t> &boxes,
           [&](int tid) {
             auto begin = std::min(tid * avg_queries, ts.num_queries);
             auto end = std::min(begin + avg_queries, ts.num_queries);
-            size_t num_results = 0;
-            std::vector<box_t> local_results;
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
 
             for (auto i = begin; i < end; i++) {
               auto &p = queries[i];
-              rtree.query(boost::geometry::index::contains(p),
-                          std::back_inserter(local_results));
+              auto out = boost::make_function_output_iterator(
+                  [&](const value_t &value) {
+                    local_results.emplace_back(value.second, i);
+                  });
+
+              rtree.query(boost::geometry::index::contains(p), out);
             }
 
             std::unique_lock<std::mutex> lock(mu);
@@ -68,6 +77,8 @@ time_stat RunPointQueryBoost(const std::vector<box_t> &boxes,
     sw.stop();
     ts.query_ms.push_back(sw.ms());
   }
+
+  ts.results = std::move(results);
   return ts;
 }
 
@@ -2,29 +2,37 @@
 #define SPATIALQUERYBENCHMARK_BOOST_RANGE_QUERY_H
 #include "stopwatch.h"
 #include "time_stat.h"
+#include <boost/iterator/function_output_iterator.hpp>
 #include <mutex>
 #include <thread>
 
 time_stat RunRangeQueryBoost(const std::vector<box_t> &boxes,
                              const std::vector<box_t> &queries,
                              const BenchmarkConfig &config) {
+  // Ids are stored next to the boxes, the results refer to them
+  using value_t = std::pair<box_t, uint32_t>;
   Stopwatch sw;
   time_stat ts;
 
   ts.num_geoms = boxes.size();
   ts.num_queries = queries.size();
 
-  boost::geometry::index::rtree<box_t,
-                                boost::geometry::index::linear<BOOST_LEAF_SIZE>,
-                                boost::geometry::index::indexable<box_t>>
+  boost::geometry::index::rtree<value_t,
+                                boost::geometry::index::linear<BOOST_LEAF_SIZE>>
       rtree;
-  std::vector<box_t> results;
+  std::vector<value_t> values;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
   std::mutex mu;
 
+  values.reserve(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++) {
+    values.emplace_back(boxes[i], i);
+  }
+
   for (int i = 0; i < config.warmup + config.repeat; i++) {
     rtree.clear();
     sw.start();
-    rtree.insert(boxes);
+    rtree.insert(values);
     sw.stop();
     ts.insert_ms.push_back(sw.ms());
   }
@@ -42,18 +50,21 @@ time_stat RunRangeQueryBoost(const std::vector<box_t> &boxes,
           [&](int tid) {
             auto begin = std::min(tid * avg_queries, ts.num_queries);
             auto end = std::min(begin + avg_queries, ts.num_queries);
-            std::vector<box_t> local_results;
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
 
             for (auto i = begin; i < end; i++) {
               auto &q = queries[i];
+              auto out = boost::make_function_output_iterator(
+                  [&](const value_t &value) {
+                    local_results.emplace_back(value.second, i);
+                  });
+
               switch (config.query_type) {
               case BenchmarkConfig::QueryType::kRangeContains:
-                rtree.query(boost::geometry::index::contains(q),
-                            std::back_inserter(local_results));
+                rtree.query(boost::geometry::index::contains(q), out);
                 break;
               case BenchmarkConfig::QueryType::kRangeIntersects:
-                rtree.query(boost::geometry::index::intersects(q),
-                            std::back_inserter(local_results));
+                rtree.query(boost::geometry::index::intersects(q), out);
                 break;
               default:
                 abort();
@@ -74,6 +85,7 @@ time_stat RunRangeQueryBoost(const std::vector<box_t> &boxes,
     ts.query_ms.push_back(sw.ms());
   }
 
+  ts.results = std::move(results);
   return ts;
 }
 #endif // SPATIALQUERYBENCHMARK_BOOST_RANGE_QUERY_H
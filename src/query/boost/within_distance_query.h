@@ -0,0 +1,97 @@
+#ifndef SPATIALQUERYBENCHMARK_BOOST_WITHIN_DISTANCE_QUERY_H
+#define SPATIALQUERYBENCHMARK_BOOST_WITHIN_DISTANCE_QUERY_H
+#include "query/within_distance.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+#include "wkt_loader.h"
+#include <boost/iterator/function_output_iterator.hpp>
+#include <mutex>
+#include <thread>
+
+time_stat RunWithinDistanceQueryBoost(const std::vector<box_t> &boxes,
+                                      const std::vector<point_t> &queries,
+                                      const BenchmarkConfig &config) {
+  // Ids are stored next to the boxes, the results refer to them
+  using value_t = std::pair<box_t, uint32_t>;
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  boost::geometry::index::rtree<value_t,
+                                boost::geometry::index::linear<BOOST_LEAF_SIZE>>
+      rtree;
+  std::vector<value_t> values;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::mutex mu;
+
+  values.reserve(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++) {
+    values.emplace_back(boxes[i], i);
+  }
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    rtree.clear();
+    sw.start();
+    rtree.insert(values);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    std::vector<std::thread> threads;
+    size_t avg_queries =
+        (ts.num_queries + config.parallelism - 1) / config.parallelism;
+
+    sw.start();
+    ts.num_results = 0;
+    ts.num_candidates = 0;
+    results.clear();
+
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_queries, ts.num_queries);
+            auto end = std::min(begin + avg_queries, ts.num_queries);
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
+            DistanceRefiner refiner;
+            size_t num_candidates = 0;
+
+            for (auto i = begin; i < end; i++) {
+              auto &p = queries[i];
+
+              refiner.Clear();
+              rtree.query(
+                  boost::geometry::index::intersects(
+                      ExpandBox(p, config.distance)),
+                  boost::make_function_output_iterator(
+                      [&](const value_t &value) {
+                        refiner.Add(value.second, value.first);
+                      }));
+              num_candidates += refiner.size();
+              refiner.Refine(box_t(p, p), config.distance, [&](uint32_t id) {
+                local_results.emplace_back(id, i);
+              });
+            }
+
+            std::unique_lock<std::mutex> lock(mu);
+            results.insert(results.end(), local_results.begin(),
+                           local_results.end());
+            ts.num_candidates += num_candidates;
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  ts.results = std::move(results);
+  return ts;
+}
+
+#endif // SPATIALQUERYBENCHMARK_BOOST_WITHIN_DISTANCE_QUERY_H
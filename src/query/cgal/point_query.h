@@ -7,8 +7,10 @@
 #include <CGAL/Fuzzy_iso_box.h>
 #include <CGAL/Kd_tree.h>
 #include <CGAL/Search_traits_2.h>
+#include <CGAL/Search_traits_adapter.h>
 #include <CGAL/Simple_cartesian.h>
 #include <CGAL/point_generators_2.h>
+#include <CGAL/property_map.h>
 
 #include <mutex>
 #include <thread>
@@ -19,7 +21,12 @@ time_stat RunPointQueryCGAL(const std::vector<box_t> &boxes,
 
   typedef CGAL::Simple_cartesian<double> Kernel;
   typedef Kernel::Point_2 Point;
-  typedef CGAL::Search_traits_2<Kernel> Traits;
+  // Query ids are stored next to the points, the results refer to them
+  typedef std::pair<Point, uint32_t> Point_and_id;
+  typedef CGAL::Search_traits_adapter<
+      Point_and_id, CGAL::First_of_pair_property_map<Point_and_id>,
+      CGAL::Search_traits_2<Kernel>>
+      Traits;
   typedef CGAL::Kd_tree<Traits> Tree;
   typedef CGAL::Fuzzy_iso_box<Traits> Fuzzy_iso_box;
 
@@ -30,13 +37,13 @@ time_stat RunPointQueryCGAL(const std::vector<box_t> &boxes,
   ts.num_queries = queries.size();
 
   Tree tree;
-  std::vector<Point> cgal_points;
+  std::vector<Point_and_id> cgal_points;
 
-  for (auto &p : queries) {
-    cgal_points.emplace_back(p.x(), p.y());
+  for (size_t i = 0; i < queries.size(); i++) {
+    cgal_points.emplace_back(Point(queries[i].x(), queries[i].y()), i);
   }
 
-  std::vector<Point> results;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
   std::mutex mu;
 
   for (int i = 0; i < config.warmup + config.repeat; i++) {
@@ -61,8 +68,8 @@ time_stat RunPointQueryCGAL(const std::vector<box_t> &boxes,
           [&](int tid) {
             auto begin = std::min(tid * avg_queries, boxes.size());
             auto end = std::min(begin + avg_queries, boxes.size());
-            size_t num_results = 0;
-            std::vector<Point> local_results;
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
+            std::vector<Point_and_id> matches;
 
             for (auto i = begin; i < end; i++) {
               auto &p = boxes[i];
@@ -71,7 +78,11 @@ time_stat RunPointQueryCGAL(const std::vector<box_t> &boxes,
               Point upper_right(p.max_corner().x(), p.max_corner().y());
               Fuzzy_iso_box range(lower_left, upper_right);
 
-              tree.search(std::back_inserter(local_results), range);
+              matches.clear();
+              tree.search(std::back_inserter(matches), range);
+              for (auto &match : matches) {
+                local_results.emplace_back(i, match.second);
+              }
             }
 
             std::unique_lock<std::mutex> lock(mu);
@@ -87,6 +98,8 @@ time_stat RunPointQueryCGAL(const std::vector<box_t> &boxes,
     sw.stop();
     ts.query_ms.push_back(sw.ms());
   }
+
+  ts.results = std::move(results);
   return ts;
 }
 
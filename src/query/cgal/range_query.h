@@ -0,0 +1,195 @@
+#ifndef SPATIALQUERYBENCHMARK_CGAL_RANGE_QUERY_H
+#define SPATIALQUERYBENCHMARK_CGAL_RANGE_QUERY_H
+#include "stopwatch.h"
+#include "time_stat.h"
+#include "wkt_loader.h"
+
+#include <CGAL/Bbox_2.h>
+#include <CGAL/box_intersection_d.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/**
+ * Batched range queries with CGAL's streamed segment-tree sweep. There is no
+ * persistent index, so the x-axis is cut into strips and each strip runs its
+ * own box_intersection_d. For intersects, a box is copied into every strip it
+ * overlaps and a pair is only reported by the strip holding max(xmin), which
+ * lies in both boxes. For contains, the query goes to the strip of its xmin
+ * only, because any box containing it also covers that strip.
+ */
+time_stat RunRangeQueryCGAL(const std::vector<box_t> &boxes,
+                            const std::vector<box_t> &queries,
+                            const BenchmarkConfig &config) {
+  typedef CGAL::Box_intersection_d::Box_with_handle_d<double, 2,
+                                                      const box_t *>
+      Box;
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  bool contains =
+      config.query_type == BenchmarkConfig::QueryType::kRangeContains;
+  coord_t min_x = std::numeric_limits<coord_t>::max();
+  coord_t max_x = std::numeric_limits<coord_t>::lowest();
+
+  for (auto &box : boxes) {
+    min_x = std::min(min_x, box.min_corner().x());
+    max_x = std::max(max_x, box.max_corner().x());
+  }
+  for (auto &q : queries) {
+    min_x = std::min(min_x, q.min_corner().x());
+    max_x = std::max(max_x, q.max_corner().x());
+  }
+
+  // More strips than threads so skewed strips can be balanced dynamically
+  int n_strips = config.parallelism * 4;
+  double strip_width = std::max(
+      (double)(max_x - min_x) / n_strips, std::numeric_limits<double>::min());
+
+  auto get_strip = [&](coord_t x) {
+    auto strip = (int)((x - min_x) / strip_width);
+    return std::min(std::max(strip, 0), n_strips - 1);
+  };
+
+  // Bucket the boxes by strip, two passes per thread: count, then scatter
+  auto partition = [&](const std::vector<box_t> &input, bool first_only,
+                       std::vector<size_t> &strip_offsets,
+                       std::vector<Box> &strip_boxes) {
+    size_t avg_boxes =
+        (input.size() + config.parallelism - 1) / config.parallelism;
+    std::vector<std::vector<size_t>> counts(
+        config.parallelism, std::vector<size_t>(n_strips + 1, 0));
+    std::vector<std::thread> threads;
+
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_boxes, input.size());
+            auto end = std::min(begin + avg_boxes, input.size());
+
+            for (auto i = begin; i < end; i++) {
+              auto &b = input[i];
+              auto s_begin = get_strip(b.min_corner().x());
+              auto s_end = first_only ? s_begin : get_strip(b.max_corner().x());
+
+              for (auto s = s_begin; s <= s_end; s++) {
+                counts[tid][s]++;
+              }
+            }
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    threads.clear();
+
+    // Exclusive scan in (strip, thread) order, so each thread has its slot
+    size_t total = 0;
+    strip_offsets.assign(n_strips + 1, 0);
+    for (int s = 0; s < n_strips; s++) {
+      strip_offsets[s] = total;
+      for (int tid = 0; tid < config.parallelism; tid++) {
+        auto n = counts[tid][s];
+        counts[tid][s] = total;
+        total += n;
+      }
+    }
+    strip_offsets[n_strips] = total;
+    strip_boxes.resize(total);
+
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_boxes, input.size());
+            auto end = std::min(begin + avg_boxes, input.size());
+
+            for (auto i = begin; i < end; i++) {
+              auto &b = input[i];
+              auto s_begin = get_strip(b.min_corner().x());
+              auto s_end = first_only ? s_begin : get_strip(b.max_corner().x());
+              CGAL::Bbox_2 bbox(b.min_corner().x(), b.min_corner().y(),
+                                b.max_corner().x(), b.max_corner().y());
+
+              for (auto s = s_begin; s <= s_end; s++) {
+                strip_boxes[counts[tid][s]++] = Box(bbox, &b);
+              }
+            }
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+
+  std::vector<size_t> box_offsets, query_offsets;
+  std::vector<Box> strip_boxes, strip_queries;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::mutex mu;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    std::vector<std::thread> threads;
+    std::atomic_int next_strip(0);
+
+    sw.start();
+    ts.num_results = 0;
+    results.clear();
+
+    partition(boxes, false, box_offsets, strip_boxes);
+    partition(queries, contains, query_offsets, strip_queries);
+
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back([&]() {
+        std::vector<std::pair<uint32_t, uint32_t>> local_results;
+        int s;
+
+        while ((s = next_strip.fetch_add(1)) < n_strips) {
+          auto callback = [&](const Box &a, const Box &b) {
+            // Both sequences share a box type, so tell them apart by handle
+            const box_t *geom = a.handle(), *query = b.handle();
+            if (geom < boxes.data() || geom >= boxes.data() + boxes.size()) {
+              std::swap(geom, query);
+            }
+
+            if (contains) {
+              if (!boost::geometry::within(*query, *geom)) {
+                return;
+              }
+            } else if (get_strip(std::max(geom->min_corner().x(),
+                                          query->min_corner().x())) != s) {
+              return;
+            }
+            local_results.emplace_back(geom - boxes.data(),
+                                       query - queries.data());
+          };
+
+          CGAL::box_intersection_d(
+              strip_boxes.begin() + box_offsets[s],
+              strip_boxes.begin() + box_offsets[s + 1],
+              strip_queries.begin() + query_offsets[s],
+              strip_queries.begin() + query_offsets[s + 1], callback);
+        }
+
+        std::unique_lock<std::mutex> lock(mu);
+        results.insert(results.end(), local_results.begin(),
+                       local_results.end());
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  ts.results = std::move(results);
+  return ts;
+}
+
+#endif // SPATIALQUERYBENCHMARK_CGAL_RANGE_QUERY_H
@@ -0,0 +1,124 @@
+#ifndef SPATIALQUERYBENCHMARK_CGAL_WITHIN_DISTANCE_QUERY_H
+#define SPATIALQUERYBENCHMARK_CGAL_WITHIN_DISTANCE_QUERY_H
+#include "query/within_distance.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+#include "wkt_loader.h"
+
+#include <CGAL/Fuzzy_iso_box.h>
+#include <CGAL/Kd_tree.h>
+#include <CGAL/Search_traits_2.h>
+#include <CGAL/Search_traits_adapter.h>
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/property_map.h>
+
+#include <mutex>
+#include <thread>
+
+/**
+ * Like the point queries, the kd-tree indexes the query points and every box
+ * probes it, here with the box expanded by the distance.
+ */
+time_stat RunWithinDistanceQueryCGAL(const std::vector<box_t> &boxes,
+                                     const std::vector<point_t> &queries,
+                                     const BenchmarkConfig &config) {
+
+  typedef CGAL::Simple_cartesian<double> Kernel;
+  typedef Kernel::Point_2 Point;
+  // Query ids are stored next to the points, the results refer to them
+  typedef std::pair<Point, uint32_t> Point_and_id;
+  typedef CGAL::Search_traits_adapter<
+      Point_and_id, CGAL::First_of_pair_property_map<Point_and_id>,
+      CGAL::Search_traits_2<Kernel>>
+      Traits;
+  typedef CGAL::Kd_tree<Traits> Tree;
+  typedef CGAL::Fuzzy_iso_box<Traits> Fuzzy_iso_box;
+
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  Tree tree;
+  std::vector<Point_and_id> cgal_points;
+
+  for (size_t i = 0; i < queries.size(); i++) {
+    cgal_points.emplace_back(Point(queries[i].x(), queries[i].y()), i);
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::mutex mu;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    tree.clear();
+    sw.start();
+    tree.insert(cgal_points.begin(), cgal_points.end());
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    std::vector<std::thread> threads;
+    size_t avg_queries =
+        (boxes.size() + config.parallelism - 1) / config.parallelism;
+
+    sw.start();
+    ts.num_results = 0;
+    ts.num_candidates = 0;
+    results.clear();
+
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_queries, boxes.size());
+            auto end = std::min(begin + avg_queries, boxes.size());
+            size_t num_candidates = 0;
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
+            std::vector<Point_and_id> candidates;
+            DistanceRefiner refiner;
+
+            for (auto i = begin; i < end; i++) {
+              auto &box = boxes[i];
+              auto expanded = ExpandBox(box, config.distance);
+
+              Point lower_left(expanded.min_corner().x(),
+                               expanded.min_corner().y());
+              Point upper_right(expanded.max_corner().x(),
+                                expanded.max_corner().y());
+              Fuzzy_iso_box range(lower_left, upper_right);
+
+              candidates.clear();
+              refiner.Clear();
+              tree.search(std::back_inserter(candidates), range);
+              for (auto &candidate : candidates) {
+                point_t pt(candidate.first.x(), candidate.first.y());
+
+                refiner.Add(candidate.second, box_t(pt, pt));
+              }
+              num_candidates += refiner.size();
+              refiner.Refine(box, config.distance, [&](uint32_t id) {
+                local_results.emplace_back(i, id);
+              });
+            }
+
+            std::unique_lock<std::mutex> lock(mu);
+            results.insert(results.end(), local_results.begin(),
+                           local_results.end());
+            ts.num_candidates += num_candidates;
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  ts.results = std::move(results);
+  return ts;
+}
+
+#endif // SPATIALQUERYBENCHMARK_CGAL_WITHIN_DISTANCE_QUERY_H
@@ -0,0 +1,34 @@
+#ifndef SPATIALQUERYBENCHMARK_GEOS_CONVERT_H
+#define SPATIALQUERYBENCHMARK_GEOS_CONVERT_H
+#include "geom_common.h"
+
+#include <geos/geom/Geometry.h>
+#include <geos/geom/GeometryFactory.h>
+#include <geos/io/WKTReader.h>
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+/**
+ * Converts polygons to GEOS geometries through WKT. Envelopes are computed
+ * here, since GEOS computes them lazily and not safely from several threads.
+ */
+inline std::vector<std::unique_ptr<geos::geom::Geometry>>
+ToGEOSGeometries(const geos::geom::GeometryFactory &factory,
+                 const std::vector<polygon_t> &polygons) {
+  geos::io::WKTReader reader(factory);
+  std::vector<std::unique_ptr<geos::geom::Geometry>> geoms;
+
+  geoms.reserve(polygons.size());
+  for (auto &polygon : polygons) {
+    std::stringstream ss;
+
+    ss << boost::geometry::wkt(polygon);
+    geoms.emplace_back(reader.read(ss.str()));
+    geoms.back()->getEnvelopeInternal();
+  }
+  return geoms;
+}
+
+#endif // SPATIALQUERYBENCHMARK_GEOS_CONVERT_H
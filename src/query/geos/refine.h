@@ -0,0 +1,50 @@
+#ifndef SPATIALQUERYBENCHMARK_GEOS_REFINE_H
+#define SPATIALQUERYBENCHMARK_GEOS_REFINE_H
+#include "geom_common.h"
+#include "query/geos/convert.h"
+
+#include <geos/geom/Envelope.h>
+#include <geos/geom/Geometry.h>
+#include <geos/geom/GeometryFactory.h>
+#include <geos/geom/PrecisionModel.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * The reference refinement, each candidate is tested with GEOS's own
+ * predicates on the polygon and the window as a GEOS rectangle. Polygons are
+ * converted once through WKT.
+ */
+class GEOSRangeRefiner {
+public:
+  GEOSRangeRefiner()
+      : pm_(new geos::geom::PrecisionModel()),
+        factory_(geos::geom::GeometryFactory::create(pm_.get(), -1)) {}
+
+  void Build(const std::vector<polygon_t> &polygons) {
+    geoms_ = ToGEOSGeometries(*factory_, polygons);
+  }
+
+  bool Intersects(uint32_t polygon_id, const box_t &q) const {
+    return geoms_[polygon_id]->intersects(ToGeometry(q).get());
+  }
+
+  bool Contains(uint32_t polygon_id, const box_t &q) const {
+    return geoms_[polygon_id]->contains(ToGeometry(q).get());
+  }
+
+private:
+  std::unique_ptr<geos::geom::PrecisionModel> pm_;
+  geos::geom::GeometryFactory::Ptr factory_;
+  std::vector<std::unique_ptr<geos::geom::Geometry>> geoms_;
+
+  std::unique_ptr<geos::geom::Geometry> ToGeometry(const box_t &q) const {
+    geos::geom::Envelope env(q.min_corner().x(), q.max_corner().x(),
+                             q.min_corner().y(), q.max_corner().y());
+
+    return factory_->toGeometry(&env);
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_GEOS_REFINE_H
@@ -2,8 +2,12 @@
 #define SPATIALQUERYBENCHMARK_GLIN_RANGE_QUERY_H
 #include "stopwatch.h"
 #include "time_stat.h"
+#include <chrono>
+#include <limits>
 #include <mutex>
+#include <numeric>
 #include <thread>
+#include <unordered_map>
 
 #include "glin/glin.h"
 
@@ -33,7 +37,6 @@ time_stat RunRangeQueryGLIN(const std::vector<box_t> &boxes,
       new geos::geom::PrecisionModel());
   geos::geom::GeometryFactory::Ptr global_factory =
       geos::geom::GeometryFactory::create(pm.get(), -1);
-  double piece_limitation = 1000; // a good value suggested in their paper
 
   // GLIN's definition of "Contains" is different from the other libraries
   // So we need to swap queries and boxes
@@ -47,70 +50,161 @@ time_stat RunRangeQueryGLIN(const std::vector<box_t> &boxes,
     geoms_ptrs.push_back(geoms_vec.back().get());
   }
 
-  double cell_xmin = -180;
-  double cell_ymin = -180;
-  double cell_x_intvl = 0.0000005;
-  double cell_y_intvl = 0.0000005;
-
-  for (int i = 0; i < config.warmup + config.repeat; i++) {
-    index.clear();
-    sw.start();
-    index.glin_bulk_load(geoms_ptrs, piece_limitation, "z", cell_xmin,
-                         cell_ymin, cell_x_intvl, cell_y_intvl, pieces);
-    sw.stop();
-    ts.insert_ms.push_back(sw.ms());
+  // Query windows are built once, outside the timed loop
+  std::vector<std::unique_ptr<geos::geom::Geometry>> query_geoms;
+
+  for (auto &q : *p_queries) {
+    geos::geom::Envelope env(q.min_corner().x(), q.max_corner().x(),
+                             q.min_corner().y(), q.max_corner().y());
+    query_geoms.emplace_back(global_factory->toGeometry(&env));
+  }
+
+  // The curve grid spans everything that is projected, 2^cell_bits cells per
+  // axis. Coordinates outside it would wrap around when cast to cell ids.
+  box_t bounds;
+  boost::geometry::assign_inverse(bounds);
+  for (auto &box : boxes) {
+    boost::geometry::expand(bounds, box);
+  }
+  for (auto &q : queries) {
+    boost::geometry::expand(bounds, q);
   }
 
-  std::vector<geos::geom::Geometry *> results;
-  std::mutex mu;
-
-  for (int i = 0; i < config.warmup + config.repeat; i++) {
-    size_t avg_queries =
-        (p_queries->size() + config.parallelism - 1) / config.parallelism;
-    std::vector<std::thread> threads;
-
-    sw.start();
-    ts.num_results = 0;
-    results.clear();
-    for (int tid = 0; tid < config.parallelism; tid++) {
-      threads.emplace_back(
-          [&](int tid) {
-            auto begin = std::min(tid * avg_queries, p_queries->size());
-            auto end = std::min(begin + avg_queries, p_queries->size());
-            std::vector<geos::geom::Geometry *> local_results;
-
-            for (auto i = begin; i < end; i++) {
-              auto &q = (*p_queries)[i];
-              geos::geom::Envelope env(q.min_corner().x(), q.max_corner().x(),
-                                       q.min_corner().y(), q.max_corner().y());
-              int count_filter = 0;
-
-              switch (config.query_type) {
-              case BenchmarkConfig::QueryType::kRangeContains:
-              case BenchmarkConfig::QueryType::kRangeIntersects:
-                index.glin_find(global_factory->toGeometry(&env).get(), "z",
-                                cell_xmin, cell_ymin, cell_x_intvl,
-                                cell_y_intvl, pieces, local_results,
-                                count_filter);
-                break;
-              default:
-                abort();
+  double n_cells = 1u << config.glin_cell_bits;
+  double cell_xmin = bounds.min_corner().x();
+  double cell_ymin = bounds.min_corner().y();
+  // Slightly wider than the extent, so the max corner stays in the last cell
+  double cell_x_intvl =
+      std::max((double)bounds.max_corner().x() - cell_xmin,
+               std::numeric_limits<double>::min()) /
+      (n_cells - 1);
+  double cell_y_intvl =
+      std::max((double)bounds.max_corner().y() - cell_ymin,
+               std::numeric_limits<double>::min()) /
+      (n_cells - 1);
+
+  std::cout << "Cell Grid " << (size_t)n_cells << "x" << (size_t)n_cells
+            << " Cell Size " << cell_x_intvl << "x" << cell_y_intvl
+            << std::endl;
+
+  auto get_avg_ms = [&](const std::vector<double> &times) {
+    return std::accumulate(times.begin() + config.warmup, times.end(), 0.0) /
+           config.repeat;
+  };
+  // Contains does not use pieces, so there is nothing to sweep
+  size_t n_settings = piece ? config.glin_piece_limits.size() : 1;
+
+  for (size_t setting = 0; setting < n_settings; setting++) {
+    double piece_limitation = config.glin_piece_limits[setting];
+
+    ts.insert_ms.clear();
+    ts.query_ms.clear();
+
+    for (int i = 0; i < config.warmup + config.repeat; i++) {
+      index.clear();
+      pieces.clear(); // glin_bulk_load appends to it
+      sw.start();
+      index.glin_bulk_load(geoms_ptrs, piece_limitation, "z", cell_xmin,
+                           cell_ymin, cell_x_intvl, cell_y_intvl, pieces);
+      sw.stop();
+      ts.insert_ms.push_back(sw.ms());
+    }
+
+    std::vector<geos::geom::Geometry *> results;
+    // The probe behind each entry of results
+    std::vector<uint32_t> probe_ids;
+    std::mutex mu;
+    std::chrono::nanoseconds total_probe_time(0), total_refine_time(0);
+
+    for (int i = 0; i < config.warmup + config.repeat; i++) {
+      size_t avg_queries =
+          (p_queries->size() + config.parallelism - 1) / config.parallelism;
+      std::vector<std::thread> threads;
+      std::chrono::nanoseconds probe_time(0), refine_time(0);
+
+      sw.start();
+      ts.num_results = 0;
+      results.clear();
+      probe_ids.clear();
+      for (int tid = 0; tid < config.parallelism; tid++) {
+        threads.emplace_back(
+            [&](int tid) {
+              auto begin = std::min(tid * avg_queries, p_queries->size());
+              auto end = std::min(begin + avg_queries, p_queries->size());
+              std::vector<geos::geom::Geometry *> local_results;
+              std::vector<uint32_t> local_probe_ids;
+              std::chrono::nanoseconds local_probe_time(0),
+                  local_refine_time(0);
+
+              for (auto i = begin; i < end; i++) {
+                int count_filter = 0;
+                auto n_before = local_results.size();
+
+                switch (config.query_type) {
+                case BenchmarkConfig::QueryType::kRangeContains:
+                case BenchmarkConfig::QueryType::kRangeIntersects:
+                  // The overload taking the timers only reads the index
+                  index.glin_find(query_geoms[i].get(), "z", cell_xmin,
+                                  cell_ymin, cell_x_intvl, cell_y_intvl, pieces,
+                                  local_results, count_filter, local_probe_time,
+                                  local_refine_time);
+                  break;
+                default:
+                  abort();
+                }
+                local_probe_ids.insert(local_probe_ids.end(),
+                                       local_results.size() - n_before, i);
               }
 
-            }
+              std::unique_lock<std::mutex> lock(mu);
+              results.insert(results.end(), local_results.begin(),
+                             local_results.end());
+              probe_ids.insert(probe_ids.end(), local_probe_ids.begin(),
+                               local_probe_ids.end());
+              probe_time += local_probe_time;
+              refine_time += local_refine_time;
+            },
+            tid);
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      ts.num_results = results.size();
+      sw.stop();
+      ts.query_ms.push_back(sw.ms());
+
+      if (i >= config.warmup) {
+        total_probe_time += probe_time;
+        total_refine_time += refine_time;
+      }
+    }
 
-            std::unique_lock<std::mutex> lock(mu);
-            results.insert(results.end(), local_results.begin(),
-                           local_results.end());
-          },
-          tid);
+    // Summed over all threads, so they can add up to more than the query time
+    std::cout << "Probe Time "
+              << total_probe_time.count() / 1000000.0 / config.repeat << " ms"
+              << std::endl;
+    std::cout << "Refine Time "
+              << total_refine_time.count() / 1000000.0 / config.repeat << " ms"
+              << std::endl;
+    std::cout << "Piece Limit " << piece_limitation << " Loading Time "
+              << get_avg_ms(ts.insert_ms) << " ms Pieces " << pieces.size()
+              << " Query Time " << get_avg_ms(ts.query_ms) << " ms"
+              << std::endl;
+
+    // GLIN returns the indexed geometries, mapped back to ids untimed. With
+    // contains the roles are swapped, the probes are the boxes.
+    std::unordered_map<geos::geom::Geometry *, uint32_t> indexed_ids;
+
+    for (size_t j = 0; j < geoms_ptrs.size(); j++) {
+      indexed_ids[geoms_ptrs[j]] = j;
     }
-    for (auto &thread : threads) {
-      thread.join();
+    ts.results.resize(results.size());
+    for (size_t j = 0; j < results.size(); j++) {
+      auto indexed_id = indexed_ids.at(results[j]);
+
+      ts.results[j] = piece ? std::make_pair(indexed_id, probe_ids[j])
+                            : std::make_pair(probe_ids[j], indexed_id);
     }
-    ts.num_results = results.size();
-    sw.stop();
-    ts.query_ms.push_back(sw.ms());
   }
 
   index.clear(); // GLIN crashes sometimes when destructing, so clear it
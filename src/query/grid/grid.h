@@ -0,0 +1,344 @@
+#ifndef SPATIALQUERYBENCHMARK_GRID_GRID_H
+#define SPATIALQUERYBENCHMARK_GRID_GRID_H
+#include "geom_common.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+/**
+ * A two-level grid. The top level is a uniform grid sized so that a cell holds
+ * about kTargetPerCell boxes, but no narrower than the average box. In the
+ * adaptive variant, top cells holding more than twice the target are split
+ * into a finer sub-grid, so dense regions of skewed data get smaller cells.
+ * The uniform grid is the same structure with every top cell left whole.
+ *
+ * A box is copied into every leaf cell it overlaps. Leaves store their boxes
+ * contiguously (CSR) as separate coordinate arrays for the SIMD filters.
+ */
+class Grid {
+  static constexpr size_t kTargetPerCell = 32;
+  static constexpr uint32_t kMaxSubCells = 256;
+
+  struct TopCell {
+    uint32_t leaf_begin;
+    uint16_t sx, sy;
+  };
+
+public:
+  void Build(const std::vector<box_t> &boxes, bool adaptive, int parallelism) {
+    Clear();
+    if (boxes.empty()) {
+      return;
+    }
+
+    box_t bounds;
+    double avg_w = 0, avg_h = 0;
+
+    boost::geometry::assign_inverse(bounds);
+    for (auto &box : boxes) {
+      boost::geometry::expand(bounds, box);
+      avg_w += box.max_corner().x() - box.min_corner().x();
+      avg_h += box.max_corner().y() - box.min_corner().y();
+    }
+    avg_w /= boxes.size();
+    avg_h /= boxes.size();
+
+    min_x_ = bounds.min_corner().x();
+    min_y_ = bounds.min_corner().y();
+    double w = std::max((double)bounds.max_corner().x() - min_x_, 1e-9);
+    double h = std::max((double)bounds.max_corner().y() - min_y_, 1e-9);
+    double n_cells = std::max(1.0, (double)boxes.size() / kTargetPerCell);
+
+    double fx = std::min(std::max(1.0, std::ceil(std::sqrt(n_cells * w / h))),
+                         n_cells);
+
+    nx_ = fx;
+    ny_ = std::max(1.0, std::ceil(n_cells / fx));
+    // Cells narrower than the boxes only multiply the copies
+    if (avg_w > 0) {
+      nx_ = std::max(1u, std::min(nx_, (uint32_t)std::ceil(w / avg_w)));
+    }
+    if (avg_h > 0) {
+      ny_ = std::max(1u, std::min(ny_, (uint32_t)std::ceil(h / avg_h)));
+    }
+    cell_w_ = w / nx_;
+    cell_h_ = h / ny_;
+    inv_cell_w_ = 1 / cell_w_;
+    inv_cell_h_ = 1 / cell_h_;
+
+    top_cells_.resize((size_t)nx_ * ny_);
+    for (auto &cell : top_cells_) {
+      cell.sx = cell.sy = 1;
+    }
+
+    if (adaptive) {
+      std::vector<std::atomic_uint32_t> top_counts(top_cells_.size());
+
+      ParallelFor(boxes.size(), parallelism, [&](size_t i) {
+        ForEachTopCell(boxes[i], [&](uint32_t cx, uint32_t cy) {
+          top_counts[cy * nx_ + cx].fetch_add(1, std::memory_order_relaxed);
+        });
+      });
+
+      for (size_t i = 0; i < top_cells_.size(); i++) {
+        auto count = top_counts[i].load();
+        if (count > 2 * kTargetPerCell) {
+          auto s = std::min(
+              (uint32_t)std::ceil(std::sqrt((double)count / kTargetPerCell)),
+              kMaxSubCells);
+          top_cells_[i].sx = top_cells_[i].sy = s;
+        }
+      }
+    }
+
+    uint32_t n_leaves = 0;
+    for (auto &cell : top_cells_) {
+      cell.leaf_begin = n_leaves;
+      n_leaves += (uint32_t)cell.sx * cell.sy;
+    }
+
+    std::vector<std::atomic<size_t>> counts(n_leaves);
+
+    ParallelFor(boxes.size(), parallelism, [&](size_t i) {
+      ForEachLeaf(boxes[i], [&](uint32_t leaf) {
+        counts[leaf].fetch_add(1, std::memory_order_relaxed);
+      });
+    });
+
+    leaf_offsets_.resize(n_leaves + 1);
+    leaf_offsets_[0] = 0;
+    for (uint32_t leaf = 0; leaf < n_leaves; leaf++) {
+      leaf_offsets_[leaf + 1] = leaf_offsets_[leaf] + counts[leaf].load();
+      // Reused as the scatter cursor
+      counts[leaf].store(leaf_offsets_[leaf]);
+    }
+
+    size_t n_entries = leaf_offsets_[n_leaves];
+    xmin_.resize(n_entries);
+    ymin_.resize(n_entries);
+    xmax_.resize(n_entries);
+    ymax_.resize(n_entries);
+    ids_.resize(n_entries);
+
+    ParallelFor(boxes.size(), parallelism, [&](size_t i) {
+      auto &box = boxes[i];
+
+      ForEachLeaf(box, [&](uint32_t leaf) {
+        auto pos = counts[leaf].fetch_add(1, std::memory_order_relaxed);
+
+        xmin_[pos] = box.min_corner().x();
+        ymin_[pos] = box.min_corner().y();
+        xmax_[pos] = box.max_corner().x();
+        ymax_[pos] = box.max_corner().y();
+        ids_[pos] = i;
+      });
+    });
+  }
+
+  void Clear() {
+    top_cells_.clear();
+    leaf_offsets_.clear();
+    xmin_.clear();
+    ymin_.clear();
+    xmax_.clear();
+    ymax_.clear();
+    ids_.clear();
+  }
+
+  /**
+   * Calls handler(geom_id) for every box intersecting q, once per box. A pair
+   * is only reported by the leaf holding the lower-left corner of the
+   * intersection, which both boxes overlap.
+   */
+  template <typename HANDLER_T>
+  void QueryIntersects(const box_t &q, std::vector<uint32_t> &buffer,
+                       HANDLER_T handler) const {
+    if (top_cells_.empty()) {
+      return;
+    }
+    ForEachLeaf(q, [&](uint32_t leaf) {
+      auto begin = leaf_offsets_[leaf];
+      auto n = Filter(leaf, buffer, [&](uint32_t *out) {
+        return simd::FilterIntersects(
+            xmin_.data() + begin, ymin_.data() + begin, xmax_.data() + begin,
+            ymax_.data() + begin, leaf_offsets_[leaf + 1] - begin,
+            q.min_corner().x(), q.min_corner().y(), q.max_corner().x(),
+            q.max_corner().y(), out);
+      });
+
+      for (size_t i = 0; i < n; i++) {
+        auto pos = begin + buffer[i];
+        auto ref_x = std::max(xmin_[pos], q.min_corner().x());
+        auto ref_y = std::max(ymin_[pos], q.min_corner().y());
+
+        if (LocateLeaf(ref_x, ref_y) == leaf) {
+          handler(ids_[pos]);
+        }
+      }
+    });
+  }
+
+  /**
+   * Calls handler(geom_id) for every box containing q. Such a box covers the
+   * min corner of q, so only the leaf of that corner is scanned.
+   */
+  template <typename HANDLER_T>
+  void QueryContains(const box_t &q, std::vector<uint32_t> &buffer,
+                     HANDLER_T handler) const {
+    if (top_cells_.empty()) {
+      return;
+    }
+    auto leaf = LocateLeaf(q.min_corner().x(), q.min_corner().y());
+    auto begin = leaf_offsets_[leaf];
+    auto n = Filter(leaf, buffer, [&](uint32_t *out) {
+      return simd::FilterContains(
+          xmin_.data() + begin, ymin_.data() + begin, xmax_.data() + begin,
+          ymax_.data() + begin, leaf_offsets_[leaf + 1] - begin,
+          q.min_corner().x(), q.min_corner().y(), q.max_corner().x(),
+          q.max_corner().y(), out);
+    });
+
+    for (size_t i = 0; i < n; i++) {
+      handler(ids_[begin + buffer[i]]);
+    }
+  }
+
+  template <typename HANDLER_T>
+  void QueryContains(const point_t &p, std::vector<uint32_t> &buffer,
+                     HANDLER_T handler) const {
+    if (top_cells_.empty()) {
+      return;
+    }
+    auto leaf = LocateLeaf(p.x(), p.y());
+    auto begin = leaf_offsets_[leaf];
+    auto n = Filter(leaf, buffer, [&](uint32_t *out) {
+      return simd::FilterContainsPoint(
+          xmin_.data() + begin, ymin_.data() + begin, xmax_.data() + begin,
+          ymax_.data() + begin, leaf_offsets_[leaf + 1] - begin, p.x(), p.y(),
+          out);
+    });
+
+    for (size_t i = 0; i < n; i++) {
+      handler(ids_[begin + buffer[i]]);
+    }
+  }
+
+  size_t get_num_leaves() const {
+    return leaf_offsets_.empty() ? 0 : leaf_offsets_.size() - 1;
+  }
+
+  size_t get_num_entries() const { return ids_.size(); }
+
+  size_t get_memory_bytes() const {
+    return top_cells_.size() * sizeof(TopCell) +
+           leaf_offsets_.size() * sizeof(size_t) +
+           ids_.size() * (4 * sizeof(coord_t) + sizeof(uint32_t));
+  }
+
+private:
+  uint32_t nx_ = 0, ny_ = 0;
+  double min_x_, min_y_;
+  double cell_w_, cell_h_;
+  double inv_cell_w_, inv_cell_h_;
+  std::vector<TopCell> top_cells_;
+  std::vector<size_t> leaf_offsets_;
+  std::vector<coord_t> xmin_, ymin_, xmax_, ymax_;
+  std::vector<uint32_t> ids_;
+
+  // All cell lookups clamp, so anything outside the bounds maps to the border
+  static uint32_t Clamp(double v, uint32_t n) {
+    return (uint32_t)std::min(std::max(v, 0.0), (double)(n - 1));
+  }
+
+  uint32_t TopX(double x) const {
+    return Clamp((x - min_x_) * inv_cell_w_, nx_);
+  }
+
+  uint32_t TopY(double y) const {
+    return Clamp((y - min_y_) * inv_cell_h_, ny_);
+  }
+
+  uint32_t SubX(double x, uint32_t cx, uint32_t sx) const {
+    return Clamp((x - min_x_ - cx * cell_w_) * inv_cell_w_ * sx, sx);
+  }
+
+  uint32_t SubY(double y, uint32_t cy, uint32_t sy) const {
+    return Clamp((y - min_y_ - cy * cell_h_) * inv_cell_h_ * sy, sy);
+  }
+
+  uint32_t LocateLeaf(double x, double y) const {
+    auto cx = TopX(x), cy = TopY(y);
+    auto &cell = top_cells_[cy * nx_ + cx];
+
+    return cell.leaf_begin + SubY(y, cy, cell.sy) * cell.sx +
+           SubX(x, cx, cell.sx);
+  }
+
+  template <typename FUNC_T>
+  void ForEachTopCell(const box_t &box, FUNC_T func) const {
+    auto cx_begin = TopX(box.min_corner().x()),
+         cx_end = TopX(box.max_corner().x());
+    auto cy_begin = TopY(box.min_corner().y()),
+         cy_end = TopY(box.max_corner().y());
+
+    for (auto cy = cy_begin; cy <= cy_end; cy++) {
+      for (auto cx = cx_begin; cx <= cx_end; cx++) {
+        func(cx, cy);
+      }
+    }
+  }
+
+  template <typename FUNC_T>
+  void ForEachLeaf(const box_t &box, FUNC_T func) const {
+    ForEachTopCell(box, [&](uint32_t cx, uint32_t cy) {
+      auto &cell = top_cells_[cy * nx_ + cx];
+      auto sx_begin = SubX(box.min_corner().x(), cx, cell.sx),
+           sx_end = SubX(box.max_corner().x(), cx, cell.sx);
+      auto sy_begin = SubY(box.min_corner().y(), cy, cell.sy),
+           sy_end = SubY(box.max_corner().y(), cy, cell.sy);
+
+      for (auto sy = sy_begin; sy <= sy_end; sy++) {
+        for (auto sx = sx_begin; sx <= sx_end; sx++) {
+          func(cell.leaf_begin + sy * cell.sx + sx);
+        }
+      }
+    });
+  }
+
+  template <typename KERNEL_T>
+  size_t Filter(uint32_t leaf, std::vector<uint32_t> &buffer,
+                KERNEL_T kernel) const {
+    auto n = leaf_offsets_[leaf + 1] - leaf_offsets_[leaf];
+
+    if (buffer.size() < n) {
+      buffer.resize(n);
+    }
+    return kernel(buffer.data());
+  }
+
+  template <typename FUNC_T>
+  static void ParallelFor(size_t n, int parallelism, FUNC_T func) {
+    size_t avg = (n + parallelism - 1) / parallelism;
+    std::vector<std::thread> threads;
+
+    for (int tid = 0; tid < parallelism; tid++) {
+      threads.emplace_back([&, tid]() {
+        auto begin = std::min(tid * avg, n);
+        auto end = std::min(begin + avg, n);
+
+        for (auto i = begin; i < end; i++) {
+          func(i);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_GRID_GRID_H
@@ -0,0 +1,90 @@
+#ifndef SPATIALQUERYBENCHMARK_GRID_RANGE_QUERY_H
+#define SPATIALQUERYBENCHMARK_GRID_RANGE_QUERY_H
+#include "query/grid/grid.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+#include <mutex>
+#include <thread>
+
+time_stat RunRangeQueryGrid(const std::vector<box_t> &boxes,
+                            const std::vector<box_t> &queries,
+                            const BenchmarkConfig &config) {
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  bool adaptive =
+      config.index_type == BenchmarkConfig::IndexType::kGridAdaptive;
+  Grid grid;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::mutex mu;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    grid.Build(boxes, adaptive, config.parallelism);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  std::cout << "Grid Leaves " << grid.get_num_leaves() << " Entries "
+            << grid.get_num_entries() << " Memory "
+            << grid.get_memory_bytes() / 1024.0 / 1024 << " MB" << std::endl;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    size_t avg_queries =
+        (ts.num_queries + config.parallelism - 1) / config.parallelism;
+    std::vector<std::thread> threads;
+
+    sw.start();
+    ts.num_results = 0;
+    results.clear();
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_queries, ts.num_queries);
+            auto end = std::min(begin + avg_queries, ts.num_queries);
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
+            std::vector<uint32_t> buffer;
+
+            for (auto i = begin; i < end; i++) {
+              auto &q = queries[i];
+              auto handler = [&](uint32_t geom_id) {
+                local_results.emplace_back(geom_id, i);
+              };
+
+              switch (config.query_type) {
+              case BenchmarkConfig::QueryType::kRangeContains:
+                // Same as Boost's within, a degenerate query is never within
+                if (q.min_corner().x() < q.max_corner().x() &&
+                    q.min_corner().y() < q.max_corner().y()) {
+                  grid.QueryContains(q, buffer, handler);
+                }
+                break;
+              case BenchmarkConfig::QueryType::kRangeIntersects:
+                grid.QueryIntersects(q, buffer, handler);
+                break;
+              default:
+                abort();
+              }
+            }
+
+            std::unique_lock<std::mutex> lock(mu);
+            results.insert(results.end(), local_results.begin(),
+                           local_results.end());
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  ts.results = std::move(results);
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_GRID_RANGE_QUERY_H
@@ -0,0 +1,115 @@
+#ifndef SPATIALQUERYBENCHMARK_QUERY_GROUP_H
+#define SPATIALQUERYBENCHMARK_QUERY_GROUP_H
+#include "benchmark_configs.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+/**
+ * Groups unordered (geom_id, query_id) pairs by query into CSR form, the geom
+ * ids of query i are geom_ids[offsets[i], offsets[i + 1]). The pairs are split
+ * into one block per worker, each block counts its pairs per query, a prefix
+ * sum over (query, block) gives every block its own range within each query,
+ * and each block scatters into its ranges without atomics. Within a query the
+ * geom ids keep the order of the pairs. Returns the bytes of the counters.
+ */
+inline size_t
+GroupByQuery(const std::vector<std::pair<uint32_t, uint32_t>> &pairs,
+             size_t num_queries, std::vector<size_t> &offsets,
+             std::vector<uint32_t> &geom_ids) {
+  // Blocks smaller than this do not pay for their counters
+  constexpr size_t kMinBlockSize = 1 << 16;
+  size_t n = pairs.size();
+  // With many queries, fewer blocks keep the counters within
+  // max(num_queries, n), no more than the pairs take
+  size_t num_blocks =
+      std::min({(size_t)parlay::num_workers(),
+                (n + kMinBlockSize - 1) / kMinBlockSize,
+                n / std::max(num_queries, (size_t)1)});
+  num_blocks = std::max(num_blocks, (size_t)1);
+  size_t block_size = (n + num_blocks - 1) / num_blocks;
+  // Counters of block b are [b * num_queries, (b + 1) * num_queries)
+  std::vector<size_t> counters(num_blocks * num_queries, 0);
+
+  parlay::parallel_for(
+      0, num_blocks,
+      [&](size_t b) {
+        auto *counts = counters.data() + b * num_queries;
+        auto end = std::min(n, (b + 1) * block_size);
+
+        for (auto i = b * block_size; i < end; i++) {
+          counts[pairs[i].second]++;
+        }
+      },
+      1);
+
+  offsets.resize(num_queries + 1);
+  parlay::parallel_for(0, num_queries, [&](size_t query_id) {
+    size_t count = 0;
+
+    for (size_t b = 0; b < num_blocks; b++) {
+      count += counters[b * num_queries + query_id];
+    }
+    offsets[query_id] = count;
+  });
+  offsets[num_queries] = parlay::scan_inplace(
+      parlay::make_slice(offsets.begin(), offsets.begin() + num_queries));
+
+  // Turns the counts into the position each block writes next
+  parlay::parallel_for(0, num_queries, [&](size_t query_id) {
+    auto pos = offsets[query_id];
+
+    for (size_t b = 0; b < num_blocks; b++) {
+      auto &counter = counters[b * num_queries + query_id];
+      auto count = counter;
+
+      counter = pos;
+      pos += count;
+    }
+  });
+
+  geom_ids.resize(n);
+  parlay::parallel_for(
+      0, num_blocks,
+      [&](size_t b) {
+        auto *pos = counters.data() + b * num_queries;
+        auto end = std::min(n, (b + 1) * block_size);
+
+        for (auto i = b * block_size; i < end; i++) {
+          geom_ids[pos[pairs[i].second]++] = pairs[i].first;
+        }
+      },
+      1);
+  return counters.size() * sizeof(size_t);
+}
+
+/**
+ * Groups ts.results by query into ts.result_offsets and ts.result_geoms. The
+ * grouping is timed on its own, it comes after the query and is not part of
+ * the query time. The aggregate R-tree only counts its results, so there is
+ * nothing to group.
+ */
+inline void GroupResults(const BenchmarkConfig &config, time_stat &ts) {
+  if (ts.results.size() != ts.num_results) {
+    std::cerr << "Grouping needs a backend that reports ids, the aggregate "
+                 "R-tree only counts"
+              << std::endl;
+    abort();
+  }
+  Stopwatch sw;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    ts.group_scratch_bytes = GroupByQuery(ts.results, ts.num_queries,
+                                          ts.result_offsets, ts.result_geoms);
+    sw.stop();
+    ts.group_ms.push_back(sw.ms());
+  }
+}
+
+#endif // SPATIALQUERYBENCHMARK_QUERY_GROUP_H
@@ -0,0 +1,72 @@
+#ifndef SPATIALQUERYBENCHMARK_QUERY_KNN_H
+#define SPATIALQUERYBENCHMARK_QUERY_KNN_H
+#include "geom_common.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// Squared distance from p to the closest point of box, 0 if box contains p
+inline double SquaredDistance(const box_t &box, const point_t &p) {
+  double dx = std::max({(double)box.min_corner().x() - p.x(), 0.0,
+                        (double)p.x() - box.max_corner().x()});
+  double dy = std::max({(double)box.min_corner().y() - p.y(), 0.0,
+                        (double)p.y() - box.max_corner().y()});
+  return dx * dx + dy * dy;
+}
+
+/**
+ * Checks kNN results of a backend against a brute-force scan over a sample of
+ * up to max_checked queries spread across the batch. Neighbours at the same
+ * distance are interchangeable, so each query compares its sorted list of k
+ * distances, not ids. results holds (geom_id, query_id) on the same boxes
+ * and queries. Returns the number of sampled queries that differ.
+ */
+inline size_t
+CheckKNN(const std::vector<box_t> &boxes, const std::vector<point_t> &queries,
+         size_t k, const std::vector<std::pair<uint32_t, uint32_t>> &results,
+         size_t max_checked = 1000) {
+  if (queries.empty()) {
+    return 0;
+  }
+  size_t stride = std::max(1ul, queries.size() / max_checked);
+  size_t n_checked = (queries.size() + stride - 1) / stride;
+  std::vector<std::vector<double>> found(n_checked);
+
+  for (auto &result : results) {
+    if (result.second % stride == 0) {
+      found[result.second / stride].push_back(
+          SquaredDistance(boxes[result.first], queries[result.second]));
+    }
+  }
+
+  auto mismatched = parlay::tabulate(n_checked, [&](size_t i) {
+    auto &p = queries[i * stride];
+    std::vector<double> expected(boxes.size());
+    size_t n = std::min(k, boxes.size());
+
+    for (size_t j = 0; j < boxes.size(); j++) {
+      expected[j] = SquaredDistance(boxes[j], p);
+    }
+    std::nth_element(expected.begin(), expected.begin() + n, expected.end());
+    expected.resize(n);
+    std::sort(expected.begin(), expected.end());
+
+    auto &actual = found[i];
+
+    std::sort(actual.begin(), actual.end());
+    return (size_t)(actual != expected);
+  });
+
+  size_t n_mismatched = parlay::reduce(mismatched);
+
+  std::cout << "KNN Check " << n_checked - n_mismatched << " of " << n_checked
+            << " sampled queries match" << std::endl;
+  return n_mismatched;
+}
+
+#endif // SPATIALQUERYBENCHMARK_QUERY_KNN_H
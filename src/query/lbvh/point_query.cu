@@ -1,6 +1,7 @@
 #include "point_query.h"
 
 #include "lbvh.cuh"
+#include "query/rtspatial/common.h"
 #include "rtspatial/utils/queue.h"
 #include "stopwatch.h"
 struct aabb_getter {
@@ -91,6 +92,7 @@ time_stat RunPointQueryLBVH(const std::vector<box_t> &boxes,
     sw.stop();
     ts.query_ms.push_back(sw.ms());
   }
+  CopyResults(results, ts.results);
 
   return ts;
 }
\ No newline at end of file
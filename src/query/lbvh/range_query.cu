@@ -1,4 +1,5 @@
 #include "lbvh.cuh"
+#include "query/rtspatial/common.h"
 #include "range_query.h"
 #include "rtspatial/utils/queue.h"
 #include "stopwatch.h"
@@ -116,6 +117,7 @@ time_stat RunRangeQueryLBVH(const std::vector<box_t> &boxes,
     sw.stop();
     ts.query_ms.push_back(sw.ms());
   }
+  CopyResults(results, ts.results);
 
   return ts;
 }
@@ -0,0 +1,378 @@
+#ifndef SPATIALQUERYBENCHMARK_LBVH_CPU_LBVH_H
+#define SPATIALQUERYBENCHMARK_LBVH_CPU_LBVH_H
+#include "geom_common.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * A CPU port of the Karras LBVH in thirdparty/lbvh. Nodes use the same layout,
+ * internal nodes take [0, n - 1), leaves take [n - 1, 2n - 1) in Morton
+ * order, and the root is node 0. Each step of the build is a parallel pass:
+ * Morton codes, a radix sort, one thread per internal node to find its range
+ * and split, then a bottom-up refit where the second child to arrive merges
+ * the boxes of its parent.
+ */
+class LinearBVH {
+  static constexpr uint32_t kInvalid = 0xFFFFFFFF;
+  static constexpr int kCodeBits = 16;
+  // Keys are unique, so a root-to-leaf path has at most 64 internal nodes
+  static constexpr int kStackSize = 128;
+
+public:
+  void Build(const std::vector<box_t> &boxes) {
+    Build(boxes.data(), boxes.size());
+  }
+
+  void Build(const box_t *boxes, size_t n) {
+    Clear();
+    if (n == 0) {
+      return;
+    }
+
+    box_t bounds;
+
+    boost::geometry::assign_inverse(bounds);
+    for (size_t i = 0; i < n; i++) {
+      boost::geometry::expand(bounds, boxes[i]);
+    }
+
+    double min_x = bounds.min_corner().x(), min_y = bounds.min_corner().y();
+    double scale_x = (double)((1u << kCodeBits) - 1) /
+                     std::max((double)bounds.max_corner().x() - min_x, 1e-9);
+    double scale_y = (double)((1u << kCodeBits) - 1) /
+                     std::max((double)bounds.max_corner().y() - min_y, 1e-9);
+
+    // The object index in the low bits keeps the keys unique, which is what
+    // the GPU version falls back to when two centres share a code
+    auto keys = parlay::tabulate(n, [&](size_t i) {
+      auto &box = boxes[i];
+      double x = ((double)box.min_corner().x() + box.max_corner().x()) / 2;
+      double y = ((double)box.min_corner().y() + box.max_corner().y()) / 2;
+      uint64_t code = Morton(Quantize((x - min_x) * scale_x),
+                             Quantize((y - min_y) * scale_y));
+
+      return (code << 32) | i;
+    });
+
+    parlay::integer_sort_inplace(keys, [](uint64_t key) { return key; });
+
+    num_objects_ = n;
+    nodes_.resize(2 * n - 1);
+    aabbs_.resize(2 * n - 1);
+
+    parlay::parallel_for(0, n, [&](size_t i) {
+      auto &node = nodes_[n - 1 + i];
+
+      node.parent = kInvalid;
+      node.left = kInvalid;
+      node.right = kInvalid;
+      node.object = (uint32_t)keys[i];
+      aabbs_[n - 1 + i] = ToAABB(boxes[node.object]);
+    });
+
+    if (n > 1) {
+      parlay::parallel_for(0, n - 1, [&](size_t i) {
+        auto range = DetermineRange(keys, i);
+        auto split = FindSplit(keys, range.first, range.second);
+        auto &node = nodes_[i];
+
+        node.object = kInvalid;
+        node.left = split == range.first ? n - 1 + split : split;
+        node.right = split + 1 == range.second ? n + split : split + 1;
+        nodes_[node.left].parent = i;
+        nodes_[node.right].parent = i;
+      });
+      nodes_[0].parent = kInvalid;
+    }
+
+    RefitInternalNodes();
+  }
+
+  /**
+   * Updates the boxes of the indexed objects in place and refits the
+   * internal nodes bottom-up, keeping the topology. boxes must hold as many
+   * boxes as the tree was built with, in the same order.
+   */
+  void Refit(const std::vector<box_t> &boxes) { Refit(boxes.data()); }
+
+  void Refit(const box_t *boxes) {
+    size_t n = num_objects_;
+
+    parlay::parallel_for(0, n, [&](size_t i) {
+      aabbs_[n - 1 + i] = ToAABB(boxes[nodes_[n - 1 + i].object]);
+    });
+    RefitInternalNodes();
+  }
+
+  void Clear() {
+    num_objects_ = 0;
+    nodes_.clear();
+    aabbs_.clear();
+  }
+
+  template <typename HANDLER_T>
+  void QueryIntersects(const box_t &q, HANDLER_T handler) const {
+    Traverse(ToAABB(q), [](const AABB &node, const AABB &q) {
+      return node.x_min <= q.x_max && node.x_max >= q.x_min &&
+             node.y_min <= q.y_max && node.y_max >= q.y_min;
+    }, handler);
+  }
+
+  /**
+   * A box containing q can only sit below nodes containing q, so the same
+   * predicate prunes internal nodes and selects leaves.
+   */
+  template <typename HANDLER_T>
+  void QueryContains(const box_t &q, HANDLER_T handler) const {
+    Traverse(ToAABB(q), [](const AABB &node, const AABB &q) {
+      return node.x_min <= q.x_min && node.x_max >= q.x_max &&
+             node.y_min <= q.y_min && node.y_max >= q.y_max;
+    }, handler);
+  }
+
+  template <typename HANDLER_T>
+  void QueryContains(const point_t &p, HANDLER_T handler) const {
+    QueryContains(box_t(p, p), handler);
+  }
+
+  // Scratch space of QueryNearest, kept by the caller to reuse across queries
+  struct NearestBuffer {
+    std::vector<std::pair<double, uint32_t>> nodes, best;
+  };
+
+  /**
+   * Best-first search for the k boxes closest to p. Nodes are expanded in the
+   * order of their distance to p, and the search stops once the closest
+   * unexpanded node is farther than the k-th box found. handler(object,
+   * squared distance) is called in ascending distance.
+   */
+  template <typename HANDLER_T>
+  void QueryNearest(const point_t &p, size_t k, NearestBuffer &buffer,
+                    HANDLER_T handler) const {
+    if (num_objects_ == 0 || k == 0) {
+      return;
+    }
+    auto &nodes = buffer.nodes;
+    auto &best = buffer.best;
+    // nodes is a min-heap by distance, best a max-heap of the k closest
+    std::greater<std::pair<double, uint32_t>> farther;
+
+    nodes.clear();
+    best.clear();
+    nodes.emplace_back(SquaredDistance(aabbs_[0], p), 0);
+
+    while (!nodes.empty()) {
+      std::pop_heap(nodes.begin(), nodes.end(), farther);
+      auto dist = nodes.back().first;
+      auto &node = nodes_[nodes.back().second];
+
+      nodes.pop_back();
+      if (best.size() == k && dist > best.front().first) {
+        break;
+      }
+
+      if (node.object != kInvalid) {
+        best.emplace_back(dist, node.object);
+        std::push_heap(best.begin(), best.end());
+        if (best.size() > k) {
+          std::pop_heap(best.begin(), best.end());
+          best.pop_back();
+        }
+        continue;
+      }
+
+      for (auto child : {node.left, node.right}) {
+        auto child_dist = SquaredDistance(aabbs_[child], p);
+
+        if (best.size() < k || child_dist <= best.front().first) {
+          nodes.emplace_back(child_dist, child);
+          std::push_heap(nodes.begin(), nodes.end(), farther);
+        }
+      }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    for (auto &e : best) {
+      handler(e.second, e.first);
+    }
+  }
+
+  size_t get_num_nodes() const { return nodes_.size(); }
+
+  size_t get_memory_bytes() const {
+    return nodes_.size() * (sizeof(Node) + sizeof(AABB));
+  }
+
+private:
+  struct Node {
+    uint32_t parent, left, right;
+    uint32_t object; // kInvalid for internal nodes
+  };
+
+  struct AABB {
+    coord_t x_min, y_min, x_max, y_max;
+  };
+
+  size_t num_objects_ = 0;
+  std::vector<Node> nodes_;
+  std::vector<AABB> aabbs_;
+
+  static AABB ToAABB(const box_t &box) {
+    return AABB{box.min_corner().x(), box.min_corner().y(),
+                box.max_corner().x(), box.max_corner().y()};
+  }
+
+  static double SquaredDistance(const AABB &box, const point_t &p) {
+    double dx = std::max({(double)box.x_min - p.x(), 0.0,
+                          (double)p.x() - box.x_max});
+    double dy = std::max({(double)box.y_min - p.y(), 0.0,
+                          (double)p.y() - box.y_max});
+    return dx * dx + dy * dy;
+  }
+
+  static uint32_t Quantize(double v) {
+    return (uint32_t)std::min(std::max(v, 0.0),
+                              (double)((1u << kCodeBits) - 1));
+  }
+
+  static uint64_t Spread(uint32_t v) {
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+  }
+
+  static uint64_t Morton(uint32_t x, uint32_t y) {
+    return Spread(x) | (Spread(y) << 1);
+  }
+
+  // Length of the common prefix of keys i and j, -1 if j is out of range
+  template <typename SEQ_T>
+  static int Delta(const SEQ_T &keys, int64_t i, int64_t j) {
+    if (j < 0 || j >= (int64_t)keys.size()) {
+      return -1;
+    }
+    return __builtin_clzll(keys[i] ^ keys[j]);
+  }
+
+  template <typename SEQ_T>
+  static std::pair<size_t, size_t> DetermineRange(const SEQ_T &keys,
+                                                  int64_t i) {
+    if (i == 0) {
+      return {0, keys.size() - 1};
+    }
+
+    int d = Delta(keys, i, i + 1) > Delta(keys, i, i - 1) ? 1 : -1;
+    int delta_min = Delta(keys, i, i - d);
+    int64_t l_max = 2;
+
+    while (Delta(keys, i, i + l_max * d) > delta_min) {
+      l_max <<= 1;
+    }
+
+    int64_t l = 0;
+
+    for (int64_t t = l_max >> 1; t > 0; t >>= 1) {
+      if (Delta(keys, i, i + (l + t) * d) > delta_min) {
+        l += t;
+      }
+    }
+
+    int64_t j = i + l * d;
+    return {std::min(i, j), std::max(i, j)};
+  }
+
+  template <typename SEQ_T>
+  static size_t FindSplit(const SEQ_T &keys, size_t first, size_t last) {
+    int delta_node = Delta(keys, first, last);
+    size_t split = first;
+    size_t stride = last - first;
+
+    do {
+      stride = (stride + 1) >> 1;
+      size_t middle = split + stride;
+
+      if (middle < last && Delta(keys, first, middle) > delta_node) {
+        split = middle;
+      }
+    } while (stride > 1);
+
+    return split;
+  }
+
+  void RefitInternalNodes() {
+    size_t n = num_objects_;
+
+    if (n < 2) {
+      return;
+    }
+
+    std::unique_ptr<std::atomic<uint32_t>[]> arrivals(
+        new std::atomic<uint32_t>[n - 1]);
+
+    parlay::parallel_for(0, n - 1, [&](size_t i) { arrivals[i] = 0; });
+
+    parlay::parallel_for(n - 1, 2 * n - 1, [&](size_t i) {
+      auto parent = nodes_[i].parent;
+
+      // The first child to arrive stops, the second sees both boxes
+      while (parent != kInvalid &&
+             arrivals[parent].fetch_add(1, std::memory_order_acq_rel) == 1) {
+        auto &node = nodes_[parent];
+        auto &l = aabbs_[node.left], &r = aabbs_[node.right];
+
+        aabbs_[parent] = AABB{std::min(l.x_min, r.x_min),
+                              std::min(l.y_min, r.y_min),
+                              std::max(l.x_max, r.x_max),
+                              std::max(l.y_max, r.y_max)};
+        parent = node.parent;
+      }
+    });
+  }
+
+  template <typename PRED_T, typename HANDLER_T>
+  void Traverse(const AABB &q, PRED_T pred, HANDLER_T &handler) const {
+    if (num_objects_ == 0) {
+      return;
+    }
+    if (num_objects_ == 1) {
+      if (pred(aabbs_[0], q)) {
+        handler(nodes_[0].object);
+      }
+      return;
+    }
+
+    uint32_t stack[kStackSize];
+    int top = 0;
+
+    stack[top++] = 0;
+    do {
+      auto &node = nodes_[stack[--top]];
+
+      for (auto child : {node.left, node.right}) {
+        if (pred(aabbs_[child], q)) {
+          auto object = nodes_[child].object;
+
+          if (object != kInvalid) {
+            handler(object);
+          } else {
+            stack[top++] = child;
+          }
+        }
+      }
+    } while (top > 0);
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_LBVH_CPU_LBVH_H
@@ -0,0 +1,83 @@
+#ifndef SPATIALQUERYBENCHMARK_LBVH_CPU_RANGE_QUERY_H
+#define SPATIALQUERYBENCHMARK_LBVH_CPU_RANGE_QUERY_H
+#include "query/lbvh_cpu/lbvh.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+#include <mutex>
+#include <thread>
+
+time_stat RunRangeQueryLBVHCPU(const std::vector<box_t> &boxes,
+                               const std::vector<box_t> &queries,
+                               const BenchmarkConfig &config) {
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  LinearBVH bvh;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::mutex mu;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    bvh.Build(boxes);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  std::cout << "LBVH Nodes " << bvh.get_num_nodes() << " Memory "
+            << bvh.get_memory_bytes() / 1024.0 / 1024 << " MB" << std::endl;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    size_t avg_queries =
+        (ts.num_queries + config.parallelism - 1) / config.parallelism;
+    std::vector<std::thread> threads;
+
+    sw.start();
+    ts.num_results = 0;
+    results.clear();
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_queries, ts.num_queries);
+            auto end = std::min(begin + avg_queries, ts.num_queries);
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
+
+            for (auto i = begin; i < end; i++) {
+              auto &q = queries[i];
+              auto handler = [&](uint32_t geom_id) {
+                local_results.emplace_back(geom_id, i);
+              };
+
+              switch (config.query_type) {
+              case BenchmarkConfig::QueryType::kRangeContains:
+                // Closed like the GPU version, degenerate queries included
+                bvh.QueryContains(q, handler);
+                break;
+              case BenchmarkConfig::QueryType::kRangeIntersects:
+                bvh.QueryIntersects(q, handler);
+                break;
+              default:
+                abort();
+              }
+            }
+
+            std::unique_lock<std::mutex> lock(mu);
+            results.insert(results.end(), local_results.begin(),
+                           local_results.end());
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  ts.results = std::move(results);
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_LBVH_CPU_RANGE_QUERY_H
@@ -7,9 +7,6 @@
 #include "kdTree/kdTree.h"
 #include "pargeo/point.h"
 
-#include <mutex>
-#include <thread>
-
 time_stat RunPointQueryParGeo(const std::vector<box_t> &boxes,
                               const std::vector<point_t> &queries,
                               const BenchmarkConfig &config) {
@@ -18,9 +15,6 @@ time_stat RunPointQueryParGeo(const std::vector<box_t> &boxes,
   Stopwatch sw;
   time_stat ts;
 
-  std::string s_val = std::to_string(config.parallelism);
-  setenv("PARLAY_NUM_THREADS", s_val.c_str(), 1);
-
   std::cout << "num_workers " << parlay::num_workers() << std::endl;
 
   parlay::sequence<pargeo_point_t> points(queries.size());
@@ -34,8 +28,7 @@ time_stat RunPointQueryParGeo(const std::vector<box_t> &boxes,
   ts.num_queries = queries.size();
 
   node_t *tree = nullptr;
-  std::vector<pargeo_point_t *> results;
-  std::mutex mu;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
 
   for (int i = 0; i < config.warmup + config.repeat; i++) {
     if (tree != nullptr) {
@@ -49,52 +42,42 @@ time_stat RunPointQueryParGeo(const std::vector<box_t> &boxes,
   }
 
   for (int i = 0; i < config.warmup + config.repeat; i++) {
-    std::vector<std::thread> threads;
-    size_t avg_queries =
-        (boxes.size() + config.parallelism - 1) / config.parallelism;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> local_results(
+        parlay::num_workers());
 
     sw.start();
     ts.num_results = 0;
     results.clear();
-    for (int tid = 0; tid < config.parallelism; tid++) {
-      threads.emplace_back(
-          [&](int tid) {
-            auto begin = std::min(tid * avg_queries, boxes.size());
-            auto end = std::min(begin + avg_queries, boxes.size());
-            std::vector<pargeo_point_t *> local_results;
-
-            for (auto i = begin; i < end; i++) {
-              auto &p = boxes[i];
-
-              pargeo_point_t p_min, p_max;
-              p_min.x[0] = p.min_corner().x();
-              p_min.x[1] = p.min_corner().y();
-              p_max.x[0] = p.max_corner().x();
-              p_max.x[1] = p.max_corner().y();
-
-              auto callback = [&](pargeo_point_t *p) {
-                local_results.push_back(p);
-              };
-
-              pargeo::kdTree::orthRangeHelper<2, node_t, pargeo_point_t,
-                                              decltype(callback)>(
-                  tree, p_min, p_max, callback);
-            }
-
-            std::unique_lock<std::mutex> lock(mu);
-            results.insert(results.end(), local_results.begin(),
-                           local_results.end());
-          },
-          tid);
-    }
-    for (auto &thread : threads) {
-      thread.join();
+    // Boxes are scheduled by parlay's work stealing instead of fixed slices,
+    // each worker appends to its own buffer
+    parlay::parallel_for(0, boxes.size(), [&](size_t geom_id) {
+      auto &p = boxes[geom_id];
+      auto &local = local_results[parlay::worker_id()];
+
+      pargeo_point_t p_min, p_max;
+      p_min.x[0] = p.min_corner().x();
+      p_min.x[1] = p.min_corner().y();
+      p_max.x[0] = p.max_corner().x();
+      p_max.x[1] = p.max_corner().y();
+
+      auto callback = [&](pargeo_point_t *p) {
+        local.emplace_back(geom_id, p - points.begin());
+      };
+
+      pargeo::kdTree::orthRangeHelper<2, node_t, pargeo_point_t,
+                                      decltype(callback)>(tree, p_min, p_max,
+                                                          callback);
+    });
+
+    for (auto &local : local_results) {
+      results.insert(results.end(), local.begin(), local.end());
     }
     ts.num_results = results.size();
     sw.stop();
     ts.query_ms.push_back(sw.ms());
   }
   pargeo::kdTree::del(tree);
+  ts.results = std::move(results);
   return ts;
 }
 
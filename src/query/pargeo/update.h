@@ -0,0 +1,282 @@
+#ifndef SPATIALQUERYBENCHMARK_PARGEO_UPDATE_H
+#define SPATIALQUERYBENCHMARK_PARGEO_UPDATE_H
+#include "stopwatch.h"
+#include "time_stat.h"
+#include "wkt_loader.h"
+
+#include "batchKdtree/binary-heap-layout/bhlkdtree.h"
+#include "batchKdtree/cache-oblivious/cokdtree.h"
+#include "batchKdtree/log-tree/logtree.h"
+
+#include <cmath>
+#include <memory>
+
+/**
+ * Batch-dynamic kd-trees from ParGeo. They store points, so insertion and
+ * deletion index the centre of each box. The point query keeps the convention
+ * of RunPointQueryParGeo, the query points are inserted and each box probes
+ * them. BHL and CO have a fixed capacity and rebuild on every batch, the
+ * log-tree only rebuilds the levels a batch carries into.
+ */
+using pargeo_dyn_point_t = pargeo::batchKdTree::point<2>;
+
+/**
+ * The trees return copies of the matching points, so the point query cannot
+ * map them back by address as RunPointQueryParGeo does. The query id travels
+ * in the point instead.
+ */
+struct pargeo_dyn_id_point_t : pargeo_dyn_point_t {
+  uint32_t id;
+
+  pargeo_dyn_id_point_t() = default;
+
+  // The leaves copy matching points out of a pointer
+  pargeo_dyn_id_point_t(const pargeo_dyn_id_point_t *p)
+      : pargeo_dyn_point_t(*p), id(p->id) {}
+};
+
+template <typename obj_t>
+using pargeo_logtree_of =
+    pargeo::batchKdTree::LogTree<21, 7, 2, obj_t, true, false>;
+template <typename obj_t>
+using pargeo_bhl_tree_of =
+    pargeo::batchKdTree::BHL_KdTree<2, obj_t, true, false>;
+template <typename obj_t>
+using pargeo_co_tree_of = pargeo::batchKdTree::CO_KdTree<2, obj_t, true, false>;
+
+using pargeo_logtree_t = pargeo_logtree_of<pargeo_dyn_point_t>;
+using pargeo_bhl_tree_t = pargeo_bhl_tree_of<pargeo_dyn_point_t>;
+using pargeo_co_tree_t = pargeo_co_tree_of<pargeo_dyn_point_t>;
+
+namespace detail {
+template <typename tree_t> std::unique_ptr<tree_t> NewBatchKdTree(size_t n) {
+  // The log-tree ignores the size, it grows on its own
+  return std::make_unique<tree_t>(
+      (int)std::ceil(std::log2(std::max(n, (size_t)2))));
+}
+
+inline parlay::sequence<pargeo_dyn_point_t>
+BoxCenters(const std::vector<box_t> &boxes) {
+  parlay::sequence<pargeo_dyn_point_t> points(boxes.size());
+
+  parlay::parallel_for(0, boxes.size(), [&](size_t i) {
+    auto &box = boxes[i];
+    points[i].x[0] = (box.min_corner().x() + box.max_corner().x()) / 2;
+    points[i].x[1] = (box.min_corner().y() + box.max_corner().y()) / 2;
+  });
+  return points;
+}
+} // namespace detail
+
+template <typename tree_t>
+time_stat RunInsertionParGeo(const std::vector<box_t> &boxes,
+                             const BenchmarkConfig &config) {
+  const auto points = detail::BoxCenters(boxes);
+  time_stat ts;
+  Stopwatch sw;
+
+  ts.num_geoms = boxes.size();
+
+  std::cout << "num_workers " << parlay::num_workers() << std::endl;
+
+  int batch = config.batch;
+
+  if (batch == -1) {
+    size_t n_steps = 100;
+    size_t avg_gemos_per_step = (boxes.size() + n_steps - 1) / n_steps;
+    size_t n_inserted = 0;
+
+    for (size_t i = 0; i < n_steps; i++) {
+      auto begin = i * avg_gemos_per_step;
+      auto size = std::min(begin + avg_gemos_per_step, boxes.size()) - begin;
+      double total_insert_time = 0;
+
+      n_inserted += size;
+
+      for (int repeat = 0; repeat < config.repeat; repeat++) {
+        auto tree = detail::NewBatchKdTree<tree_t>(n_inserted);
+
+        sw.start();
+        tree->insert(points.cut(0, n_inserted));
+        sw.stop();
+        total_insert_time += sw.ms();
+      }
+
+      std::cout << "Step " << i << " Geoms " << n_inserted << " Insert Time "
+                << total_insert_time / config.repeat << " ms" << std::endl;
+    }
+  } else {
+    double total_insert_time = 0;
+    size_t n_batches = (boxes.size() + batch - 1) / batch;
+
+    for (int repeat = 0; repeat < config.repeat; repeat++) {
+      auto tree = detail::NewBatchKdTree<tree_t>(boxes.size());
+
+      sw.start();
+      for (size_t batch_id = 0; batch_id < n_batches; batch_id++) {
+        size_t batch_begin = batch_id * batch;
+        size_t batch_end = std::min(batch_begin + batch, boxes.size());
+
+        tree->insert(points.cut(batch_begin, batch_end));
+      }
+      sw.stop();
+      total_insert_time += sw.ms();
+    }
+    total_insert_time /= config.repeat;
+
+    std::cout << "Batch " << batch << " Geoms " << boxes.size()
+              << " Insert Time " << total_insert_time << " ms Throughput "
+              << boxes.size() / (total_insert_time / 1000) << " geoms/sec"
+              << std::endl;
+  }
+  return ts;
+}
+
+template <typename tree_t>
+time_stat RunDeletionParGeo(const std::vector<box_t> &boxes,
+                            const BenchmarkConfig &config) {
+  const auto points = detail::BoxCenters(boxes);
+  time_stat ts;
+  Stopwatch sw;
+
+  ts.num_geoms = boxes.size();
+
+  std::cout << "num_workers " << parlay::num_workers() << std::endl;
+
+  int batch = config.batch;
+
+  if (batch == -1) {
+    size_t n_steps = 100;
+    size_t avg_gemos_per_step = (boxes.size() + n_steps - 1) / n_steps;
+    size_t n_inserted = 0;
+
+    for (size_t i = 0; i < n_steps; i++) {
+      auto begin = i * avg_gemos_per_step;
+      auto size = std::min(begin + avg_gemos_per_step, boxes.size()) - begin;
+      double total_delete_time = 0;
+
+      n_inserted += size;
+
+      for (int repeat = 0; repeat < config.repeat; repeat++) {
+        auto tree = detail::NewBatchKdTree<tree_t>(n_inserted);
+        parlay::sequence<pargeo_dyn_point_t> deleted_points(
+            points.begin(), points.begin() + n_inserted);
+
+        tree->insert(points.cut(0, n_inserted));
+
+        sw.start();
+        tree->bulk_erase(deleted_points);
+        sw.stop();
+        total_delete_time += sw.ms();
+      }
+
+      std::cout << "Step " << i << " Geoms " << n_inserted << " Delete Time "
+                << total_delete_time / config.repeat << " ms" << std::endl;
+    }
+  } else {
+    double total_delete_time = 0;
+    size_t n_batches = (boxes.size() + batch - 1) / batch;
+
+    for (int repeat = 0; repeat < config.repeat; repeat++) {
+      auto tree = detail::NewBatchKdTree<tree_t>(boxes.size());
+
+      tree->insert(points.cut(0, points.size()));
+
+      for (size_t batch_id = 0; batch_id < n_batches; batch_id++) {
+        size_t batch_begin = batch_id * batch;
+        size_t batch_end = std::min(batch_begin + batch, boxes.size());
+        parlay::sequence<pargeo_dyn_point_t> deleted_points(
+            points.begin() + batch_begin, points.begin() + batch_end);
+
+        sw.start();
+        tree->bulk_erase(deleted_points);
+        sw.stop();
+        total_delete_time += sw.ms();
+      }
+    }
+
+    total_delete_time /= config.repeat;
+
+    std::cout << "Batch " << batch << " Geoms " << boxes.size()
+              << " Delete Time " << total_delete_time << " ms Throughput "
+              << boxes.size() / (total_delete_time / 1000) << " geoms/sec"
+              << std::endl;
+  }
+  return ts;
+}
+
+template <template <typename> class tree_of>
+time_stat RunPointQueryParGeoDynamic(const std::vector<box_t> &boxes,
+                                     const std::vector<point_t> &queries,
+                                     const BenchmarkConfig &config) {
+  using tree_t = tree_of<pargeo_dyn_id_point_t>;
+  const auto points = parlay::tabulate(queries.size(), [&](size_t i) {
+    pargeo_dyn_id_point_t p;
+    p.x[0] = queries[i].x();
+    p.x[1] = queries[i].y();
+    p.id = i;
+    return p;
+  });
+  Stopwatch sw;
+  time_stat ts;
+
+  std::cout << "num_workers " << parlay::num_workers() << std::endl;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  std::unique_ptr<tree_t> tree;
+  // Loading goes through the same batched inserts as the insertion benchmark
+  size_t batch = config.batch == -1 ? points.size() : config.batch;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    tree = detail::NewBatchKdTree<tree_t>(points.size());
+
+    sw.start();
+    for (size_t begin = 0; begin < points.size(); begin += batch) {
+      auto end = std::min(begin + batch, points.size());
+
+      tree->insert(points.cut(begin, end));
+    }
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> local_results(
+        parlay::num_workers());
+
+    sw.start();
+    ts.num_results = 0;
+    results.clear();
+    parlay::parallel_for(0, boxes.size(), [&](size_t geom_id) {
+      auto &p = boxes[geom_id];
+      pargeo_dyn_id_point_t p_min, p_max;
+
+      p_min.x[0] = p.min_corner().x();
+      p_min.x[1] = p.min_corner().y();
+      p_max.x[0] = p.max_corner().x();
+      p_max.x[1] = p.max_corner().y();
+
+      auto matches = tree->orthogonalQuery(p_min, p_max);
+      auto &local = local_results[parlay::worker_id()];
+
+      for (auto &match : matches) {
+        local.emplace_back(geom_id, match.id);
+      }
+    });
+
+    for (auto &local : local_results) {
+      results.insert(results.end(), local.begin(), local.end());
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+  ts.results = std::move(results);
+  return ts;
+}
+
+#endif // SPATIALQUERYBENCHMARK_PARGEO_UPDATE_H
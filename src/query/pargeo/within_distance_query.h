@@ -0,0 +1,101 @@
+#ifndef SPATIALQUERYBENCHMARK_PARGEO_WITHIN_DISTANCE_QUERY_H
+#define SPATIALQUERYBENCHMARK_PARGEO_WITHIN_DISTANCE_QUERY_H
+#include "query/within_distance.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+#include "wkt_loader.h"
+
+#include "kdTree/kdTree.h"
+#include "pargeo/point.h"
+
+/**
+ * Like the point queries, the kd-tree indexes the query points and every box
+ * probes it, here with the box expanded by the distance.
+ */
+time_stat RunWithinDistanceQueryParGeo(const std::vector<box_t> &boxes,
+                                       const std::vector<point_t> &queries,
+                                       const BenchmarkConfig &config) {
+  using pargeo_point_t = pargeo::fpoint<2>;
+  using node_t = pargeo::kdTree::node<2, pargeo_point_t>;
+  Stopwatch sw;
+  time_stat ts;
+
+  parlay::sequence<pargeo_point_t> points(queries.size());
+
+  for (size_t i = 0; i < queries.size(); i++) {
+    points[i].x[0] = queries[i].x();
+    points[i].x[1] = queries[i].y();
+  }
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  node_t *tree = nullptr;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    if (tree != nullptr) {
+      pargeo::kdTree::del(tree);
+    }
+
+    sw.start();
+    tree = pargeo::kdTree::build<2, pargeo_point_t>(points, true);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> local_results(
+        parlay::num_workers());
+    std::vector<DistanceRefiner> refiners(parlay::num_workers());
+    std::vector<size_t> num_candidates(parlay::num_workers(), 0);
+
+    sw.start();
+    ts.num_results = 0;
+    ts.num_candidates = 0;
+    results.clear();
+    parlay::parallel_for(0, boxes.size(), [&](size_t geom_id) {
+      auto &box = boxes[geom_id];
+      auto worker_id = parlay::worker_id();
+      auto &local = local_results[worker_id];
+      auto &refiner = refiners[worker_id];
+      auto expanded = ExpandBox(box, config.distance);
+
+      pargeo_point_t p_min, p_max;
+      p_min.x[0] = expanded.min_corner().x();
+      p_min.x[1] = expanded.min_corner().y();
+      p_max.x[0] = expanded.max_corner().x();
+      p_max.x[1] = expanded.max_corner().y();
+
+      auto callback = [&](pargeo_point_t *p) {
+        point_t pt(p->x[0], p->x[1]);
+
+        refiner.Add(p - points.begin(), box_t(pt, pt));
+      };
+
+      refiner.Clear();
+      pargeo::kdTree::orthRangeHelper<2, node_t, pargeo_point_t,
+                                      decltype(callback)>(tree, p_min, p_max,
+                                                          callback);
+      num_candidates[worker_id] += refiner.size();
+      refiner.Refine(box, config.distance, [&](uint32_t query_id) {
+        local.emplace_back(geom_id, query_id);
+      });
+    });
+
+    for (auto &local : local_results) {
+      results.insert(results.end(), local.begin(), local.end());
+    }
+    for (auto n : num_candidates) {
+      ts.num_candidates += n;
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+  pargeo::kdTree::del(tree);
+  ts.results = std::move(results);
+  return ts;
+}
+
+#endif // SPATIALQUERYBENCHMARK_PARGEO_WITHIN_DISTANCE_QUERY_H
@@ -0,0 +1,39 @@
+#ifndef SPATIALQUERYBENCHMARK_PBSM_JOIN_H
+#define SPATIALQUERYBENCHMARK_PBSM_JOIN_H
+#include "query/pbsm/pbsm.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+
+/**
+ * Joins boxes with queries on intersects. PBSM keeps no index between runs,
+ * partitioning is part of every join and is counted in the query time.
+ */
+time_stat RunJoinPBSM(const std::vector<box_t> &boxes,
+                      const std::vector<box_t> &queries,
+                      const BenchmarkConfig &config) {
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  PBSM pbsm;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    results = pbsm.Join(boxes, queries);
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  std::cout << "PBSM Tiles " << pbsm.get_tiles_per_axis() << "x"
+            << pbsm.get_tiles_per_axis() << " Replication "
+            << (double)pbsm.get_num_copies() / (boxes.size() + queries.size())
+            << std::endl;
+
+  ts.results = std::move(results);
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_PBSM_JOIN_H
@@ -0,0 +1,209 @@
+#ifndef SPATIALQUERYBENCHMARK_PBSM_PBSM_H
+#define SPATIALQUERYBENCHMARK_PBSM_PBSM_H
+#include "geom_common.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+/**
+ * Partition Based Spatial-Merge join of two box sets on the intersects
+ * predicate. Both inputs are partitioned by a uniform grid of tiles over their
+ * joint bounds, a box is copied to every tile it overlaps, and each tile is
+ * joined by a forward-scan plane sweep over x. A pair found in several tiles
+ * is only reported by the tile holding the lower-left corner of the
+ * intersection of the two boxes, so no result is emitted twice.
+ */
+class PBSM {
+  // Average number of box copies per tile the grid is sized for
+  static constexpr size_t kEntriesPerTile = 1024;
+  static constexpr uint32_t kMaxTilesPerAxis = 1024;
+
+public:
+  /**
+   * Returns (r_id, s_id) for every intersecting pair of r and s.
+   */
+  std::vector<std::pair<uint32_t, uint32_t>> Join(const std::vector<box_t> &r,
+                                                  const std::vector<box_t> &s) {
+    num_copies_ = 0;
+    if (r.empty() || s.empty()) {
+      tiles_per_axis_ = 0;
+      return {};
+    }
+
+    box_t bounds;
+
+    boost::geometry::assign_inverse(bounds);
+    for (auto *boxes : {&r, &s}) {
+      for (auto &box : *boxes) {
+        boost::geometry::expand(bounds, box);
+      }
+    }
+
+    tiles_per_axis_ = std::ceil(std::sqrt((double)(r.size() + s.size()) /
+                                          kEntriesPerTile));
+    tiles_per_axis_ = std::min(std::max(tiles_per_axis_, 1u), kMaxTilesPerAxis);
+    min_x_ = bounds.min_corner().x();
+    min_y_ = bounds.min_corner().y();
+    scale_x_ = tiles_per_axis_ /
+               std::max((double)bounds.max_corner().x() - min_x_, 1e-9);
+    scale_y_ = tiles_per_axis_ /
+               std::max((double)bounds.max_corner().y() - min_y_, 1e-9);
+
+    auto r_part = Partition(r);
+    auto s_part = Partition(s);
+    size_t n_tiles = (size_t)tiles_per_axis_ * tiles_per_axis_;
+
+    num_copies_ = r_part.entries.size() + s_part.entries.size();
+
+    auto tile_results = parlay::tabulate(
+        n_tiles,
+        [&](size_t tile) {
+          std::vector<std::pair<uint32_t, uint32_t>> results;
+
+          SweepTile(tile, r, r_part, s, s_part, results);
+          return results;
+        },
+        1);
+
+    auto flat = parlay::flatten(tile_results);
+
+    return std::vector<std::pair<uint32_t, uint32_t>>(flat.begin(), flat.end());
+  }
+
+  uint32_t get_tiles_per_axis() const { return tiles_per_axis_; }
+
+  // Number of box copies over all tiles, inputs replicated by the grid
+  size_t get_num_copies() const { return num_copies_; }
+
+private:
+  struct Partitioned {
+    // (tile, box id) sorted by tile, tile t owns [offsets[t], offsets[t + 1])
+    parlay::sequence<std::pair<uint32_t, uint32_t>> entries;
+    parlay::sequence<size_t> offsets;
+  };
+
+  struct Entry {
+    coord_t x_min, y_min, x_max, y_max;
+    uint32_t id;
+  };
+
+  uint32_t tiles_per_axis_ = 0;
+  size_t num_copies_ = 0;
+  double min_x_, min_y_;
+  double scale_x_, scale_y_;
+
+  uint32_t Clamp(double v) const {
+    return (uint32_t)std::min(std::max(v, 0.0), tiles_per_axis_ - 1.0);
+  }
+
+  uint32_t TileX(double x) const { return Clamp((x - min_x_) * scale_x_); }
+
+  uint32_t TileY(double y) const { return Clamp((y - min_y_) * scale_y_); }
+
+  Partitioned Partition(const std::vector<box_t> &boxes) const {
+    Partitioned part;
+    auto copies = parlay::tabulate(boxes.size(), [&](size_t i) {
+      auto &box = boxes[i];
+      auto x_min = TileX(box.min_corner().x()),
+           x_max = TileX(box.max_corner().x());
+      auto y_min = TileY(box.min_corner().y()),
+           y_max = TileY(box.max_corner().y());
+      parlay::sequence<std::pair<uint32_t, uint32_t>> tiles;
+
+      tiles.reserve((x_max - x_min + 1) * (y_max - y_min + 1));
+      for (auto y = y_min; y <= y_max; y++) {
+        for (auto x = x_min; x <= x_max; x++) {
+          tiles.emplace_back(y * tiles_per_axis_ + x, (uint32_t)i);
+        }
+      }
+      return tiles;
+    });
+
+    part.entries = parlay::flatten(copies);
+    parlay::integer_sort_inplace(part.entries,
+                                 [](const auto &e) { return e.first; });
+
+    size_t n_tiles = (size_t)tiles_per_axis_ * tiles_per_axis_;
+
+    part.offsets = parlay::tabulate(n_tiles + 1, [&](size_t tile) {
+      return (size_t)(std::lower_bound(part.entries.begin(),
+                                       part.entries.end(),
+                                       std::make_pair((uint32_t)tile, 0u)) -
+                      part.entries.begin());
+    });
+    return part;
+  }
+
+  static std::vector<Entry> Gather(const std::vector<box_t> &boxes,
+                                   const Partitioned &part, size_t tile) {
+    std::vector<Entry> entries;
+
+    entries.reserve(part.offsets[tile + 1] - part.offsets[tile]);
+    for (auto i = part.offsets[tile]; i < part.offsets[tile + 1]; i++) {
+      auto id = part.entries[i].second;
+      auto &box = boxes[id];
+
+      entries.push_back(Entry{box.min_corner().x(), box.min_corner().y(),
+                              box.max_corner().x(), box.max_corner().y(), id});
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) { return a.x_min < b.x_min; });
+    return entries;
+  }
+
+  void SweepTile(size_t tile, const std::vector<box_t> &r,
+                 const Partitioned &r_part, const std::vector<box_t> &s,
+                 const Partitioned &s_part,
+                 std::vector<std::pair<uint32_t, uint32_t>> &results) const {
+    if (r_part.offsets[tile] == r_part.offsets[tile + 1] ||
+        s_part.offsets[tile] == s_part.offsets[tile + 1]) {
+      return;
+    }
+    auto r_entries = Gather(r, r_part, tile);
+    auto s_entries = Gather(s, s_part, tile);
+
+    auto emit = [&](const Entry &a, const Entry &b, uint32_t r_id,
+                    uint32_t s_id) {
+      if (a.y_min > b.y_max || a.y_max < b.y_min) {
+        return;
+      }
+      // Reference point: the lower-left corner of the intersection
+      auto ref_x = std::max(a.x_min, b.x_min);
+      auto ref_y = std::max(a.y_min, b.y_min);
+
+      if (TileY(ref_y) * tiles_per_axis_ + TileX(ref_x) == tile) {
+        results.emplace_back(r_id, s_id);
+      }
+    };
+
+    size_t i = 0, j = 0;
+
+    // Each step takes the box with the smaller x_min and pairs it with the
+    // boxes of the other side that start before it ends
+    while (i < r_entries.size() && j < s_entries.size()) {
+      if (r_entries[i].x_min <= s_entries[j].x_min) {
+        auto &a = r_entries[i];
+
+        for (auto k = j; k < s_entries.size() && s_entries[k].x_min <= a.x_max;
+             k++) {
+          emit(a, s_entries[k], a.id, s_entries[k].id);
+        }
+        i++;
+      } else {
+        auto &b = s_entries[j];
+
+        for (auto k = i; k < r_entries.size() && r_entries[k].x_min <= b.x_max;
+             k++) {
+          emit(r_entries[k], b, r_entries[k].id, b.id);
+        }
+        j++;
+      }
+    }
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_PBSM_PBSM_H
@@ -1,10 +1,16 @@
 #include <iostream>
-#include <optix_function_table_definition.h>
 #include "benchmark_configs.h"
 #include "wkt_loader.h"
 
 #include "flags.h"
+#include "query/group.h"
+#include "query/geos/pip_query.h"
+#include "query/pip_cpu/pip_query.h"
+#include "query/rtspatial_cpu/pip_query.h"
+#ifdef USE_GPU
+#include <optix_function_table_definition.h>
 #include "query/rtspatial/pip_query.h"
+#endif
 
 template <typename GEOM_T>
 void DumpBoxes(const std::string &output, const std::vector<GEOM_T> &geoms) {
@@ -45,7 +51,29 @@ int main(int argc, char *argv[]) {
     std::cout << "Loaded polygons " << polygons.size() << std::endl;
     auto points = LoadPoints(conf.query, conf.limit);
     std::cout << "Loaded points " << points.size() << std::endl;
-    ts = RunPIPQueryRTSpatial(polygons, points, conf);
+    switch (conf.index_type) {
+#ifdef USE_GPU
+    case BenchmarkConfig::IndexType::kRTSpatial:
+      ts = RunPIPQueryRTSpatial(polygons, points, conf);
+      break;
+#endif
+    case BenchmarkConfig::IndexType::kRTSpatialCPU:
+      ts = RunPIPQueryRTSpatialCPU(polygons, points, conf);
+      break;
+    case BenchmarkConfig::IndexType::kRTree:
+    case BenchmarkConfig::IndexType::kGrid:
+    case BenchmarkConfig::IndexType::kGridAdaptive:
+    case BenchmarkConfig::IndexType::kQuadTree:
+    case BenchmarkConfig::IndexType::kLBVHCPU:
+      ts = RunPIPQueryCPU(polygons, points, conf);
+      break;
+    case BenchmarkConfig::IndexType::kGEOSPrepared:
+      ts = RunPIPQueryGEOSPrepared(polygons, points, conf);
+      break;
+    default:
+      std::cerr << "Invalid Index Type" << std::endl;
+      abort();
+    }
     break;
   }
   default:
@@ -53,6 +81,10 @@ int main(int argc, char *argv[]) {
     abort();
   }
 
+  if (conf.csr) {
+    GroupResults(conf, ts);
+  }
+
   if (!ts.insert_ms.empty()) {
     std::cout << "Loading Time " << GetAverageTime(ts.insert_ms, conf) << " ms"
               << std::endl;
@@ -70,6 +102,18 @@ int main(int argc, char *argv[]) {
                   << std::endl;
       }
     }
+    if (ts.num_candidates > 0) {
+      std::cout << "Filter Candidates " << ts.num_candidates << std::endl;
+    }
+    if (!ts.group_ms.empty()) {
+      std::cout << "Group Time " << GetAverageTime(ts.group_ms, conf)
+                << " ms Memory "
+                << (ts.result_offsets.size() * sizeof(size_t) +
+                    ts.result_geoms.size() * sizeof(uint32_t) +
+                    ts.group_scratch_bytes) /
+                       1024.0 / 1024
+                << " MB" << std::endl;
+    }
     std::cout << "Results " << ts.num_results << std::endl;
     std::cout << "Selectivity: "
               << (double)ts.num_results / (ts.num_queries * ts.num_geoms)
@@ -0,0 +1,96 @@
+#ifndef SPATIALQUERYBENCHMARK_PIP_CPU_BOX_FILTER_H
+#define SPATIALQUERYBENCHMARK_PIP_CPU_BOX_FILTER_H
+#include "benchmark_configs.h"
+#include "query/grid/grid.h"
+#include "query/lbvh_cpu/lbvh.h"
+#include "query/quadtree/quadtree.h"
+#include "wkt_loader.h"
+
+#include <boost/iterator/function_output_iterator.hpp>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/**
+ * The filter step of the CPU PIP engine. Wraps one of the CPU box indexes,
+ * chosen by -index_type, behind a single point query that reports the ids of
+ * the boxes containing the point. Queries are read-only and thread-safe.
+ */
+class BoxFilter {
+  using value_t = std::pair<box_t, uint32_t>;
+
+public:
+  void Build(const std::vector<box_t> &boxes, const BenchmarkConfig &config) {
+    type_ = config.index_type;
+    switch (type_) {
+    case BenchmarkConfig::IndexType::kRTree: {
+      std::vector<value_t> values;
+
+      values.reserve(boxes.size());
+      for (size_t i = 0; i < boxes.size(); i++) {
+        values.emplace_back(boxes[i], i);
+      }
+      // The packing constructor, the boxes are static
+      rtree_ = rtree_t(values.begin(), values.end());
+      break;
+    }
+    case BenchmarkConfig::IndexType::kGrid:
+    case BenchmarkConfig::IndexType::kGridAdaptive:
+      grid_.Build(boxes,
+                  type_ == BenchmarkConfig::IndexType::kGridAdaptive,
+                  config.parallelism);
+      break;
+    case BenchmarkConfig::IndexType::kQuadTree:
+      quadtree_.Build(boxes);
+      break;
+    case BenchmarkConfig::IndexType::kLBVHCPU:
+      bvh_.Build(boxes);
+      break;
+    default:
+      std::cerr << "Index type has no CPU PIP filter" << std::endl;
+      abort();
+    }
+  }
+
+  /**
+   * Calls handler(id) for every box containing p. buffer is scratch space of
+   * the SIMD filters, kept by the caller to reuse across queries.
+   */
+  template <typename HANDLER_T>
+  void Query(const point_t &p, std::vector<uint32_t> &buffer,
+             HANDLER_T handler) const {
+    switch (type_) {
+    case BenchmarkConfig::IndexType::kRTree:
+      rtree_.query(boost::geometry::index::contains(p),
+                   boost::make_function_output_iterator(
+                       [&](const value_t &value) { handler(value.second); }));
+      break;
+    case BenchmarkConfig::IndexType::kGrid:
+    case BenchmarkConfig::IndexType::kGridAdaptive:
+      grid_.QueryContains(p, buffer, handler);
+      break;
+    case BenchmarkConfig::IndexType::kQuadTree:
+      quadtree_.QueryContains(p, buffer, handler);
+      break;
+    case BenchmarkConfig::IndexType::kLBVHCPU:
+      bvh_.QueryContains(p, handler);
+      break;
+    default:
+      break;
+    }
+  }
+
+private:
+  using rtree_t =
+      boost::geometry::index::rtree<value_t,
+                                    boost::geometry::index::linear<
+                                        BOOST_LEAF_SIZE>>;
+
+  BenchmarkConfig::IndexType type_;
+  rtree_t rtree_;
+  Grid grid_;
+  QuadTree quadtree_;
+  LinearBVH bvh_;
+};
+
+#endif // SPATIALQUERYBENCHMARK_PIP_CPU_BOX_FILTER_H
@@ -0,0 +1,222 @@
+#ifndef SPATIALQUERYBENCHMARK_PIP_CPU_EDGE_SLABS_H
+#define SPATIALQUERYBENCHMARK_PIP_CPU_EDGE_SLABS_H
+#include "geom_common.h"
+#include "query/pip_cpu/polygons.h"
+#include "simd.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Splits the y-extent of every polygon with at least a threshold of vertices
+ * into horizontal slabs and lists the edges overlapping each slab. The ray of
+ * the crossing test is horizontal, so only edges spanning the point's y can
+ * cross it, and they all overlap the point's slab. A test then touches one
+ * slab instead of the whole polygon. Edges spanning several slabs are copied
+ * into each of them. Edges are taken from the rings, so the (0, 0) separators
+ * of FlatPolygons do not show up here.
+ */
+class EdgeSlabs {
+  static constexpr uint32_t kInvalid = 0xFFFFFFFF;
+  // Average edges per slab, ignoring copies
+  static constexpr size_t kEdgesPerSlab = 16;
+  static constexpr size_t kMaxSlabs = 4096;
+  // Fewer slabs for jagged polygons, so the copies stay within this factor
+  static constexpr double kMaxCopiesPerEdge = 4;
+
+public:
+  void Build(const std::vector<polygon_t> &polygons, uint32_t threshold) {
+    Clear();
+    slab_ids_.assign(polygons.size(), kInvalid);
+    if (threshold == 0) {
+      return;
+    }
+
+    std::vector<uint32_t> selected;
+
+    for (size_t i = 0; i < polygons.size(); i++) {
+      if (CountVertices(polygons[i]) >= threshold) {
+        slab_ids_[i] = selected.size();
+        selected.push_back(i);
+      }
+    }
+
+    auto built = parlay::tabulate(
+        selected.size(),
+        [&](size_t i) { return BuildPolygon(polygons[selected[i]]); }, 1);
+
+    polygons_.resize(selected.size());
+    for (size_t i = 0; i < built.size(); i++) {
+      auto &local = built[i];
+      auto &info = polygons_[i];
+      auto edge_base = (uint32_t)x0_.size();
+
+      info = local.info;
+      info.slab_begin = slab_offsets_.size();
+      for (size_t s = 0; s < local.slab_offsets.size() - 1; s++) {
+        slab_offsets_.push_back(edge_base + local.slab_offsets[s]);
+      }
+      x0_.insert(x0_.end(), local.x0.begin(), local.x0.end());
+      y0_.insert(y0_.end(), local.y0.begin(), local.y0.end());
+      x1_.insert(x1_.end(), local.x1.begin(), local.x1.end());
+      y1_.insert(y1_.end(), local.y1.begin(), local.y1.end());
+    }
+    slab_offsets_.push_back(x0_.size());
+  }
+
+  void Clear() {
+    slab_ids_.clear();
+    polygons_.clear();
+    slab_offsets_.clear();
+    x0_.clear();
+    y0_.clear();
+    x1_.clear();
+    y1_.clear();
+  }
+
+  bool Covers(uint32_t polygon_id) const {
+    return !slab_ids_.empty() && slab_ids_[polygon_id] != kInvalid;
+  }
+
+  /**
+   * Crossing test of a covered polygon over the edges of p's slab. n_edges is
+   * set to the number of edges tested.
+   */
+  bool Contains(uint32_t polygon_id, const point_t &p, size_t &n_edges) const {
+    auto &info = polygons_[slab_ids_[polygon_id]];
+
+    n_edges = 0;
+    if (p.y() < info.ymin || p.y() > info.ymax) {
+      return false;
+    }
+    auto slab = info.slab_begin + info.SlabOf(p.y());
+    auto begin = slab_offsets_[slab];
+
+    n_edges = slab_offsets_[slab + 1] - begin;
+    return simd::EdgeCrossingParity(x0_.data() + begin, y0_.data() + begin,
+                                    x1_.data() + begin, y1_.data() + begin,
+                                    n_edges, p.x(), p.y());
+  }
+
+  size_t get_num_polygons() const { return polygons_.size(); }
+
+  size_t get_num_slabs() const {
+    return slab_offsets_.empty() ? 0 : slab_offsets_.size() - 1;
+  }
+
+  // Edges over all slabs, counting the copies
+  size_t get_num_edges() const { return x0_.size(); }
+
+  size_t get_memory_bytes() const {
+    return slab_ids_.size() * sizeof(uint32_t) +
+           polygons_.size() * sizeof(PolygonInfo) +
+           slab_offsets_.size() * sizeof(uint32_t) +
+           x0_.size() * 4 * sizeof(coord_t);
+  }
+
+private:
+  struct PolygonInfo {
+    coord_t ymin, ymax;
+    double scale; // slabs per unit of y
+    uint32_t n_slabs;
+    uint32_t slab_begin;
+
+    // Monotonic in y, so an edge and any y inside it agree on the slabs
+    uint32_t SlabOf(coord_t y) const {
+      auto slab = (int64_t)(((double)y - ymin) * scale);
+
+      return std::min((int64_t)n_slabs - 1, std::max((int64_t)0, slab));
+    }
+  };
+
+  // The slabs of one polygon, offsets relative to its own edges
+  struct LocalSlabs {
+    PolygonInfo info;
+    std::vector<uint32_t> slab_offsets;
+    std::vector<coord_t> x0, y0, x1, y1;
+  };
+
+  std::vector<uint32_t> slab_ids_; // per polygon, kInvalid if not covered
+  std::vector<PolygonInfo> polygons_;
+  std::vector<uint32_t> slab_offsets_;
+  // Edge endpoints in the order pnpoly uses them, vertex i then vertex j
+  std::vector<coord_t> x0_, y0_, x1_, y1_;
+
+  static uint32_t CountVertices(const polygon_t &polygon) {
+    size_t n = polygon.outer().size();
+
+    for (auto &inner : polygon.inners()) {
+      n += inner.size();
+    }
+    return n;
+  }
+
+  static LocalSlabs BuildPolygon(const polygon_t &polygon) {
+    LocalSlabs local;
+    auto &info = local.info;
+    size_t n_edges = 0;
+    double sum_spans = 0;
+
+    info.ymin = std::numeric_limits<coord_t>::max();
+    info.ymax = std::numeric_limits<coord_t>::lowest();
+    ForEachEdge(polygon, [&](const point_t &pi, const point_t &pj) {
+      info.ymin = std::min(info.ymin, pi.y());
+      info.ymax = std::max(info.ymax, pi.y());
+      sum_spans += std::abs((double)pi.y() - pj.y());
+      n_edges++;
+    });
+
+    auto height = std::max((double)info.ymax - info.ymin, 1e-9);
+    // An edge is copied into about span / height * n_slabs slabs
+    auto max_slabs = kMaxCopiesPerEdge * n_edges * height /
+                     std::max(sum_spans, 1e-9);
+
+    info.n_slabs = std::max(
+        1.0, std::min({(double)kMaxSlabs, (double)(n_edges / kEdgesPerSlab),
+                       max_slabs}));
+    info.scale = info.n_slabs / height;
+
+    std::vector<uint32_t> counts(info.n_slabs + 1, 0);
+    auto slab_range = [&](const point_t &pi, const point_t &pj) {
+      return std::make_pair(info.SlabOf(std::min(pi.y(), pj.y())),
+                            info.SlabOf(std::max(pi.y(), pj.y())));
+    };
+
+    ForEachEdge(polygon, [&](const point_t &pi, const point_t &pj) {
+      auto range = slab_range(pi, pj);
+
+      for (auto s = range.first; s <= range.second; s++) {
+        counts[s + 1]++;
+      }
+    });
+    for (size_t s = 0; s < info.n_slabs; s++) {
+      counts[s + 1] += counts[s];
+    }
+    local.slab_offsets = counts;
+    local.x0.resize(counts.back());
+    local.y0.resize(counts.back());
+    local.x1.resize(counts.back());
+    local.y1.resize(counts.back());
+
+    ForEachEdge(polygon, [&](const point_t &pi, const point_t &pj) {
+      auto range = slab_range(pi, pj);
+
+      for (auto s = range.first; s <= range.second; s++) {
+        auto pos = counts[s]++;
+
+        local.x0[pos] = pi.x();
+        local.y0[pos] = pi.y();
+        local.x1[pos] = pj.x();
+        local.y1[pos] = pj.y();
+      }
+    });
+    return local;
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_PIP_CPU_EDGE_SLABS_H
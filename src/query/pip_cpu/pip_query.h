@@ -0,0 +1,172 @@
+#ifndef SPATIALQUERYBENCHMARK_PIP_CPU_PIP_QUERY_H
+#define SPATIALQUERYBENCHMARK_PIP_CPU_PIP_QUERY_H
+#include "query/pip_cpu/box_filter.h"
+#include "query/pip_cpu/edge_slabs.h"
+#include "query/pip_cpu/polygons.h"
+#include "query/pip_cpu/raster.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+
+#include "parlay/primitives.h"
+
+/**
+ * Point-in-polygon on the CPU. The polygon MBRs are indexed by the box index
+ * named by -index_type, each point collects the polygons whose MBR contains
+ * it, and the candidates are refined by the SIMD crossing test. Points are
+ * spread over parlay's work-stealing scheduler, since a few points in large
+ * polygons can cost far more than the rest. With -pip_slab_threshold, large
+ * polygons are refined over the edges of one slab instead of all of them.
+ * With -pip_raster_resolution, candidates in raster cells that are entirely
+ * inside or outside are answered without a crossing test.
+ */
+time_stat RunPIPQueryCPU(const std::vector<polygon_t> &polygons,
+                         const std::vector<point_t> &points,
+                         const BenchmarkConfig &config) {
+  Stopwatch sw;
+  time_stat ts;
+  FlatPolygons flat;
+
+  ts.num_geoms = polygons.size();
+  ts.num_queries = points.size();
+
+  sw.start();
+  flat.Build(polygons);
+  sw.stop();
+
+  std::cout << "Flatten Time " << sw.ms() << " ms Memory "
+            << flat.get_memory_bytes() / 1024.0 / 1024 << " MB" << std::endl;
+
+  EdgeSlabs slabs;
+
+  sw.start();
+  slabs.Build(polygons, config.pip_slab_threshold);
+  sw.stop();
+
+  if (slabs.get_num_polygons() > 0) {
+    std::cout << "Edge Slabs Polygons " << slabs.get_num_polygons()
+              << " Slabs " << slabs.get_num_slabs() << " Edges "
+              << slabs.get_num_edges() << " Build Time " << sw.ms()
+              << " ms Memory " << slabs.get_memory_bytes() / 1024.0 / 1024
+              << " MB" << std::endl;
+  }
+
+  PolygonRaster raster;
+
+  sw.start();
+  raster.Build(polygons, flat, config.pip_raster_resolution);
+  sw.stop();
+
+  if (!raster.empty()) {
+    std::cout << "Raster Resolution " << config.pip_raster_resolution
+              << " Build Time " << sw.ms() << " ms Memory "
+              << raster.get_memory_bytes() / 1024.0 / 1024 << " MB"
+              << std::endl;
+  }
+
+  BoxFilter filter;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  double refine_ms = 0;
+  size_t num_edges_tested = 0;
+  size_t num_skipped = 0;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    filter.Build(flat.get_boxes(), config);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> local_results(
+        parlay::num_workers());
+    std::vector<std::vector<uint32_t>> buffers(parlay::num_workers());
+    std::vector<std::vector<uint32_t>> candidates(parlay::num_workers());
+    std::vector<size_t> num_candidates(parlay::num_workers(), 0);
+    std::vector<size_t> num_edges(parlay::num_workers(), 0);
+    std::vector<size_t> num_raster_hits(parlay::num_workers(), 0);
+    std::vector<double> refine_us(parlay::num_workers(), 0);
+
+    sw.start();
+    ts.num_results = 0;
+    ts.num_candidates = 0;
+    results.clear();
+    parlay::parallel_for(0, points.size(), [&](size_t query_id) {
+      auto &p = points[query_id];
+      auto worker_id = parlay::worker_id();
+      auto &local = local_results[worker_id];
+      auto &cands = candidates[worker_id];
+      Stopwatch refine_sw;
+
+      cands.clear();
+      filter.Query(p, buffers[worker_id],
+                   [&](uint32_t polygon_id) { cands.push_back(polygon_id); });
+      num_candidates[worker_id] += cands.size();
+
+      refine_sw.start();
+      for (auto polygon_id : cands) {
+        bool inside;
+
+        if (!raster.empty()) {
+          auto cell = raster.Classify(polygon_id, p);
+
+          if (cell != PolygonRaster::Cell::kBoundary) {
+            num_raster_hits[worker_id]++;
+            if (cell == PolygonRaster::Cell::kInside) {
+              local.emplace_back(polygon_id, query_id);
+            }
+            continue;
+          }
+        }
+        if (slabs.Covers(polygon_id)) {
+          size_t n;
+
+          inside = slabs.Contains(polygon_id, p, n);
+          num_edges[worker_id] += n;
+        } else {
+          inside = flat.Contains(polygon_id, p);
+          num_edges[worker_id] += flat.get_num_vertices(polygon_id);
+        }
+        if (inside) {
+          local.emplace_back(polygon_id, query_id);
+        }
+      }
+      refine_sw.stop();
+      refine_us[worker_id] += refine_sw.us();
+    });
+
+    for (auto &local : local_results) {
+      results.insert(results.end(), local.begin(), local.end());
+    }
+    for (auto n : num_candidates) {
+      ts.num_candidates += n;
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+
+    refine_ms = 0;
+    num_edges_tested = 0;
+    num_skipped = 0;
+    for (size_t worker_id = 0; worker_id < num_edges.size(); worker_id++) {
+      refine_ms += refine_us[worker_id] / 1000;
+      num_edges_tested += num_edges[worker_id];
+      num_skipped += num_raster_hits[worker_id];
+    }
+  }
+
+  if (!raster.empty()) {
+    std::cout << "Raster Skipped " << num_skipped << " of "
+              << ts.num_candidates << " Tests ("
+              << 100.0 * num_skipped / std::max(1ul, ts.num_candidates)
+              << "%)" << std::endl;
+  }
+
+  // Summed over the workers, so it compares with query time x parallelism
+  std::cout << "Refine CPU Time " << refine_ms << " ms Edges per Candidate "
+            << (double)num_edges_tested / std::max(1ul, ts.num_candidates)
+            << std::endl;
+
+  ts.results = std::move(results);
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_PIP_CPU_PIP_QUERY_H
@@ -0,0 +1,148 @@
+#ifndef SPATIALQUERYBENCHMARK_PIP_CPU_POLYGONS_H
+#define SPATIALQUERYBENCHMARK_PIP_CPU_POLYGONS_H
+#include "geom_common.h"
+#include "simd.h"
+
+#include "parlay/primitives.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Calls func(vertex i, vertex j) for every edge of every ring, in the order
+ * pnpoly visits them.
+ */
+template <typename FUNC_T>
+void ForEachEdge(const polygon_t &polygon, FUNC_T func) {
+  auto visit = [&](const polygon_t::ring_type &ring) {
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+      func(ring[i], ring[j]);
+    }
+  };
+
+  visit(polygon.outer());
+  for (auto &inner : polygon.inners()) {
+    visit(inner);
+  }
+}
+
+/**
+ * Polygons flattened the same way as PIPContext on the GPU. Polygon i owns
+ * vertices [row_offsets[i], row_offsets[i + 1]), its rings separated by (0, 0)
+ * so one crossing test handles the holes. The coordinates are kept as two
+ * arrays instead of PIPVertex, so the test loads eight edges at a time. The
+ * start of every ring is kept as well, for tests that walk the rings alone.
+ */
+class FlatPolygons {
+public:
+  void Build(const std::vector<polygon_t> &polygons) {
+    auto sizes = parlay::tabulate(polygons.size(), [&](size_t i) {
+      auto &polygon = polygons[i];
+      // A separator before the outer ring and after every ring
+      size_t n = polygon.outer().size() + 2;
+
+      for (auto &inner : polygon.inners()) {
+        n += inner.size() + 1;
+      }
+      return (uint32_t)n;
+    });
+    auto total = parlay::scan_inplace(sizes);
+    auto n_rings = parlay::tabulate(polygons.size(), [&](size_t i) {
+      return (uint32_t)(polygons[i].inners().size() + 1);
+    });
+    auto total_rings = parlay::scan_inplace(n_rings);
+
+    row_offsets_.assign(sizes.begin(), sizes.end());
+    row_offsets_.push_back(total);
+    ring_offsets_.assign(n_rings.begin(), n_rings.end());
+    ring_offsets_.push_back(total_rings);
+    ring_begins_.resize(total_rings);
+    x_.resize(total);
+    y_.resize(total);
+    boxes_.resize(polygons.size());
+
+    parlay::parallel_for(0, polygons.size(), [&](size_t i) {
+      auto &polygon = polygons[i];
+      auto tail = row_offsets_[i];
+      auto ring = ring_offsets_[i];
+      auto append = [&](coord_t x, coord_t y) {
+        x_[tail] = x;
+        y_[tail] = y;
+        tail++;
+      };
+      box_t mbr;
+
+      boost::geometry::assign_inverse(mbr);
+      // https://wrfranklin.org/Research/Short_Notes/pnpoly.html
+      append(0, 0);
+      ring_begins_[ring++] = tail;
+      for (auto &p : polygon.outer()) {
+        append(p.x(), p.y());
+        boost::geometry::expand(mbr, p);
+      }
+      append(0, 0);
+      for (auto &inner : polygon.inners()) {
+        ring_begins_[ring++] = tail;
+        for (auto &p : inner) {
+          append(p.x(), p.y());
+        }
+        append(0, 0);
+      }
+      boxes_[i] = mbr;
+    });
+  }
+
+  size_t size() const { return boxes_.size(); }
+
+  // MBRs of the outer rings, which the filter indexes
+  const std::vector<box_t> &get_boxes() const { return boxes_; }
+
+  uint32_t get_num_vertices(uint32_t polygon_id) const {
+    return row_offsets_[polygon_id + 1] - row_offsets_[polygon_id];
+  }
+
+  bool Contains(uint32_t polygon_id, const point_t &p) const {
+    auto begin = row_offsets_[polygon_id];
+
+    return simd::CrossingParity(x_.data() + begin, y_.data() + begin,
+                                get_num_vertices(polygon_id), p.x(), p.y());
+  }
+
+  /**
+   * Calls pred(x, y, n) on the closed vertex list of each ring until it
+   * returns true, and returns whether it did.
+   */
+  template <typename PRED_T>
+  bool AnyRing(uint32_t polygon_id, PRED_T pred) const {
+    for (auto r = ring_offsets_[polygon_id]; r < ring_offsets_[polygon_id + 1];
+         r++) {
+      auto begin = ring_begins_[r];
+      // Every ring is followed by one separator
+      auto end = (r + 1 < ring_offsets_[polygon_id + 1]
+                      ? ring_begins_[r + 1]
+                      : row_offsets_[polygon_id + 1]) -
+                 1;
+
+      if (pred(x_.data() + begin, y_.data() + begin, end - begin)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t get_memory_bytes() const {
+    return (row_offsets_.size() + ring_offsets_.size() + ring_begins_.size()) *
+               sizeof(uint32_t) +
+           x_.size() * 2 * sizeof(coord_t) + boxes_.size() * sizeof(box_t);
+  }
+
+private:
+  std::vector<uint32_t> row_offsets_;
+  // Rings of polygon i are [ring_offsets_[i], ring_offsets_[i + 1])
+  std::vector<uint32_t> ring_offsets_;
+  std::vector<uint32_t> ring_begins_;
+  std::vector<coord_t> x_, y_;
+  std::vector<box_t> boxes_;
+};
+
+#endif // SPATIALQUERYBENCHMARK_PIP_CPU_POLYGONS_H
@@ -0,0 +1,194 @@
+#ifndef SPATIALQUERYBENCHMARK_PIP_CPU_RASTER_H
+#define SPATIALQUERYBENCHMARK_PIP_CPU_RASTER_H
+#include "geom_common.h"
+#include "query/pip_cpu/polygons.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A fixed-resolution raster over the MBR of every polygon, with each cell
+ * marked inside, outside or boundary. Boundary cells are the cells an edge
+ * passes through, found conservatively row by row. A cell no edge touches is
+ * entirely inside or entirely outside, and so is every cell next to it in the
+ * same row until an edge intervenes, so one crossing test at a cell centre
+ * classifies a whole run. Points in inside or outside cells need no crossing
+ * test, only boundary cells fall through to the exact test.
+ */
+class PolygonRaster {
+  // Cells widened by this fraction when marking edges, against rounding
+  static constexpr double kMargin = 1e-3;
+  static constexpr int kCellsPerWord = 32; // 2 bits per cell
+
+public:
+  enum class Cell : uint8_t { kOutside = 0, kInside = 1, kBoundary = 2 };
+
+  void Build(const std::vector<polygon_t> &polygons, const FlatPolygons &flat,
+             uint32_t resolution) {
+    Clear();
+    resolution_ = resolution;
+    if (resolution == 0) {
+      return;
+    }
+    words_per_polygon_ =
+        (resolution * resolution + kCellsPerWord - 1) / kCellsPerWord;
+    cells_.assign(polygons.size() * words_per_polygon_, 0);
+    frames_.resize(polygons.size());
+
+    parlay::parallel_for(
+        0, polygons.size(),
+        [&](size_t i) { BuildPolygon(i, polygons[i], flat); }, 1);
+  }
+
+  void Clear() {
+    resolution_ = 0;
+    words_per_polygon_ = 0;
+    cells_.clear();
+    frames_.clear();
+  }
+
+  bool empty() const { return resolution_ == 0; }
+
+  // p must lie in the MBR of the polygon, which the filter guarantees
+  Cell Classify(uint32_t polygon_id, const point_t &p) const {
+    auto &frame = frames_[polygon_id];
+
+    return GetCell(polygon_id, frame.Column(p.x(), resolution_),
+                   frame.Row(p.y(), resolution_));
+  }
+
+  size_t get_memory_bytes() const {
+    return cells_.size() * sizeof(uint64_t) + frames_.size() * sizeof(Frame);
+  }
+
+private:
+  // Maps coordinates to cells, the same way when building and querying
+  struct Frame {
+    coord_t xmin, ymin;
+    coord_t scale_x, scale_y; // cells per unit
+
+    static int Clamp(double v, uint32_t resolution) {
+      return (int)std::min((double)resolution - 1, std::max(0.0, v));
+    }
+
+    double ColumnOf(double x) const { return (x - xmin) * scale_x; }
+
+    double RowOf(double y) const { return (y - ymin) * scale_y; }
+
+    int Column(coord_t x, uint32_t resolution) const {
+      return Clamp(ColumnOf(x), resolution);
+    }
+
+    int Row(coord_t y, uint32_t resolution) const {
+      return Clamp(RowOf(y), resolution);
+    }
+  };
+
+  uint32_t resolution_ = 0;
+  size_t words_per_polygon_ = 0;
+  std::vector<uint64_t> cells_;
+  std::vector<Frame> frames_;
+
+  Cell GetCell(uint32_t polygon_id, int col, int row) const {
+    size_t cell = (size_t)row * resolution_ + col;
+    auto word = cells_[polygon_id * words_per_polygon_ + cell / kCellsPerWord];
+
+    return (Cell)((word >> (cell % kCellsPerWord * 2)) & 3);
+  }
+
+  void SetCell(uint32_t polygon_id, int col, int row, Cell value) {
+    size_t cell = (size_t)row * resolution_ + col;
+    auto &word =
+        cells_[polygon_id * words_per_polygon_ + cell / kCellsPerWord];
+    auto shift = cell % kCellsPerWord * 2;
+
+    word = (word & ~(3ull << shift)) | ((uint64_t)value << shift);
+  }
+
+  void BuildPolygon(uint32_t polygon_id, const polygon_t &polygon,
+                    const FlatPolygons &flat) {
+    auto &mbr = flat.get_boxes()[polygon_id];
+    auto &frame = frames_[polygon_id];
+    auto res = (int)resolution_;
+    double width = (double)mbr.max_corner().x() - mbr.min_corner().x();
+    double height = (double)mbr.max_corner().y() - mbr.min_corner().y();
+
+    frame.xmin = mbr.min_corner().x();
+    frame.ymin = mbr.min_corner().y();
+    frame.scale_x = width > 0 ? resolution_ / width : 0;
+    frame.scale_y = height > 0 ? resolution_ / height : 0;
+
+    // Degenerate polygons always take the exact test
+    if (width <= 0 || height <= 0) {
+      for (int row = 0; row < res; row++) {
+        for (int col = 0; col < res; col++) {
+          SetCell(polygon_id, col, row, Cell::kBoundary);
+        }
+      }
+      return;
+    }
+
+    // Marks the cells of every row band the edge passes through
+    ForEachEdge(polygon, [&](const point_t &pi, const point_t &pj) {
+      double y_lo = std::min(pi.y(), pj.y()), y_hi = std::max(pi.y(), pj.y());
+      auto row_lo = Frame::Clamp(frame.RowOf(y_lo) - kMargin, resolution_);
+      auto row_hi = Frame::Clamp(frame.RowOf(y_hi) + kMargin, resolution_);
+
+      for (auto row = row_lo; row <= row_hi; row++) {
+        double x_lo, x_hi;
+
+        if (pi.y() == pj.y()) {
+          x_lo = std::min(pi.x(), pj.x());
+          x_hi = std::max(pi.x(), pj.x());
+        } else {
+          // The part of the edge within the band, clipped to the edge
+          double band_lo =
+              std::max(y_lo, (double)frame.ymin + row / frame.scale_y);
+          double band_hi =
+              std::min(y_hi, (double)frame.ymin + (row + 1) / frame.scale_y);
+          double slope = ((double)pj.x() - pi.x()) / ((double)pj.y() - pi.y());
+          double xa = pi.x() + (band_lo - pi.y()) * slope;
+          double xb = pi.x() + (band_hi - pi.y()) * slope;
+
+          x_lo = std::min(xa, xb);
+          x_hi = std::max(xa, xb);
+        }
+
+        auto col_lo = Frame::Clamp(frame.ColumnOf(x_lo) - kMargin, resolution_);
+        auto col_hi = Frame::Clamp(frame.ColumnOf(x_hi) + kMargin, resolution_);
+
+        for (auto col = col_lo; col <= col_hi; col++) {
+          SetCell(polygon_id, col, row, Cell::kBoundary);
+        }
+      }
+    });
+
+    // Classifies each run of non-boundary cells by the centre of its first
+    for (int row = 0; row < res; row++) {
+      bool in_run = false;
+      Cell run_value = Cell::kOutside;
+
+      for (int col = 0; col < res; col++) {
+        if (GetCell(polygon_id, col, row) == Cell::kBoundary) {
+          in_run = false;
+          continue;
+        }
+        if (!in_run) {
+          point_t centre(frame.xmin + (col + 0.5) / frame.scale_x,
+                         frame.ymin + (row + 0.5) / frame.scale_y);
+
+          run_value = flat.Contains(polygon_id, centre) ? Cell::kInside
+                                                        : Cell::kOutside;
+          in_run = true;
+        }
+        SetCell(polygon_id, col, row, run_value);
+      }
+    }
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_PIP_CPU_RASTER_H
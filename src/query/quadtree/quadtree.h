@@ -0,0 +1,298 @@
+#ifndef SPATIALQUERYBENCHMARK_QUADTREE_QUADTREE_H
+#define SPATIALQUERYBENCHMARK_QUADTREE_QUADTREE_H
+#include "geom_common.h"
+#include "simd.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * A linear MX-CIF quadtree. Every box is stored in the smallest quadrant that
+ * fully contains it, identified by (code, level), where code is the Morton
+ * code of the quadrant's lower-left cell at the deepest level. The entries
+ * are sorted by (code, level), so the whole subtree of a quadrant is one
+ * contiguous run that starts with the quadrant's own boxes. Nodes are never
+ * materialized, queries walk the implicit tree and binary search the runs.
+ */
+class QuadTree {
+  static constexpr int kMaxLevel = 16;
+  static constexpr int kLevelBits = 5;
+
+  using key_t = uint64_t;
+
+public:
+  void Build(const std::vector<box_t> &boxes) {
+    Clear();
+    if (boxes.empty()) {
+      return;
+    }
+
+    box_t bounds;
+
+    boost::geometry::assign_inverse(bounds);
+    for (auto &box : boxes) {
+      boost::geometry::expand(bounds, box);
+    }
+
+    min_x_ = bounds.min_corner().x();
+    min_y_ = bounds.min_corner().y();
+    // Maps the max corner to the last cell instead of one past it
+    scale_x_ = (double)((1u << kMaxLevel) - 1) /
+               std::max((double)bounds.max_corner().x() - min_x_, 1e-9);
+    scale_y_ = (double)((1u << kMaxLevel) - 1) /
+               std::max((double)bounds.max_corner().y() - min_y_, 1e-9);
+
+    auto entries = parlay::tabulate(boxes.size(), [&](size_t i) {
+      auto &box = boxes[i];
+      auto ix_min = CellX(box.min_corner().x()),
+           ix_max = CellX(box.max_corner().x());
+      auto iy_min = CellY(box.min_corner().y()),
+           iy_max = CellY(box.max_corner().y());
+      auto diff = (ix_min ^ ix_max) | (iy_min ^ iy_max);
+      // Number of low bits the box spans, it fits one level up per bit
+      int shift = diff == 0 ? 0 : 32 - __builtin_clz(diff);
+      int level = kMaxLevel - shift;
+      auto code = Morton(ix_min >> shift << shift, iy_min >> shift << shift);
+
+      return std::make_pair(MakeKey(code, level), (uint32_t)i);
+    });
+
+    parlay::integer_sort_inplace(entries,
+                                 [](const auto &e) { return e.first; });
+
+    keys_.resize(entries.size());
+    ids_.resize(entries.size());
+    xmin_.resize(entries.size());
+    ymin_.resize(entries.size());
+    xmax_.resize(entries.size());
+    ymax_.resize(entries.size());
+
+    parlay::parallel_for(0, entries.size(), [&](size_t i) {
+      auto &box = boxes[entries[i].second];
+
+      keys_[i] = entries[i].first;
+      ids_[i] = entries[i].second;
+      xmin_[i] = box.min_corner().x();
+      ymin_[i] = box.min_corner().y();
+      xmax_[i] = box.max_corner().x();
+      ymax_[i] = box.max_corner().y();
+    });
+  }
+
+  void Clear() {
+    keys_.clear();
+    ids_.clear();
+    xmin_.clear();
+    ymin_.clear();
+    xmax_.clear();
+    ymax_.clear();
+  }
+
+  template <typename HANDLER_T>
+  void QueryIntersects(const box_t &q, std::vector<uint32_t> &buffer,
+                       HANDLER_T handler) const {
+    if (keys_.empty()) {
+      return;
+    }
+    QueryRect rect{CellX(q.min_corner().x()), CellY(q.min_corner().y()),
+                   CellX(q.max_corner().x()), CellY(q.max_corner().y())};
+
+    VisitIntersects(0, 0, 0, 0, keys_.size(), rect, q, buffer, handler);
+  }
+
+  /**
+   * A box containing q lives in a quadrant containing q, so only the path of
+   * quadrants down to the smallest one holding q is scanned.
+   */
+  template <typename HANDLER_T>
+  void QueryContains(const box_t &q, std::vector<uint32_t> &buffer,
+                     HANDLER_T handler) const {
+    if (keys_.empty()) {
+      return;
+    }
+    QueryRect rect{CellX(q.min_corner().x()), CellY(q.min_corner().y()),
+                   CellX(q.max_corner().x()), CellY(q.max_corner().y())};
+
+    VisitPath(rect, buffer, [&](size_t begin, size_t end, uint32_t *out) {
+      return simd::FilterContains(
+          xmin_.data() + begin, ymin_.data() + begin, xmax_.data() + begin,
+          ymax_.data() + begin, end - begin, q.min_corner().x(),
+          q.min_corner().y(), q.max_corner().x(), q.max_corner().y(), out);
+    }, handler);
+  }
+
+  template <typename HANDLER_T>
+  void QueryContains(const point_t &p, std::vector<uint32_t> &buffer,
+                     HANDLER_T handler) const {
+    if (keys_.empty()) {
+      return;
+    }
+    auto ix = CellX(p.x()), iy = CellY(p.y());
+    QueryRect rect{ix, iy, ix, iy};
+
+    VisitPath(rect, buffer, [&](size_t begin, size_t end, uint32_t *out) {
+      return simd::FilterContainsPoint(
+          xmin_.data() + begin, ymin_.data() + begin, xmax_.data() + begin,
+          ymax_.data() + begin, end - begin, p.x(), p.y(), out);
+    }, handler);
+  }
+
+  size_t get_num_entries() const { return keys_.size(); }
+
+  size_t get_memory_bytes() const {
+    return keys_.size() *
+           (sizeof(key_t) + sizeof(uint32_t) + 4 * sizeof(coord_t));
+  }
+
+private:
+  struct QueryRect {
+    uint32_t x_min, y_min, x_max, y_max;
+  };
+
+  double min_x_, min_y_;
+  double scale_x_, scale_y_;
+  std::vector<key_t> keys_;
+  std::vector<uint32_t> ids_;
+  std::vector<coord_t> xmin_, ymin_, xmax_, ymax_;
+
+  static uint32_t Clamp(double v) {
+    return (uint32_t)std::min(std::max(v, 0.0),
+                              (double)((1u << kMaxLevel) - 1));
+  }
+
+  uint32_t CellX(double x) const { return Clamp((x - min_x_) * scale_x_); }
+
+  uint32_t CellY(double y) const { return Clamp((y - min_y_) * scale_y_); }
+
+  static uint64_t Spread(uint32_t v) {
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+  }
+
+  static uint64_t Morton(uint32_t x, uint32_t y) {
+    return Spread(x) | (Spread(y) << 1);
+  }
+
+  static key_t MakeKey(uint64_t code, int level) {
+    return (code << kLevelBits) | level;
+  }
+
+  size_t LowerBound(size_t begin, size_t end, key_t key) const {
+    return std::lower_bound(keys_.begin() + begin, keys_.begin() + end, key) -
+           keys_.begin();
+  }
+
+  template <typename KERNEL_T, typename HANDLER_T>
+  void Scan(size_t begin, size_t end, std::vector<uint32_t> &buffer,
+            KERNEL_T kernel, HANDLER_T handler) const {
+    if (begin == end) {
+      return;
+    }
+    if (buffer.size() < end - begin) {
+      buffer.resize(end - begin);
+    }
+    auto n = kernel(begin, end, buffer.data());
+
+    for (size_t i = 0; i < n; i++) {
+      handler(ids_[begin + buffer[i]]);
+    }
+  }
+
+  /**
+   * Visits the quadrant (level, x, y) in cells of that level, whose subtree
+   * occupies entries [begin, end). A quadrant inside the query is scanned in
+   * one pass, a partially overlapped one scans its own boxes and recurses.
+   */
+  template <typename HANDLER_T>
+  void VisitIntersects(int level, uint32_t x, uint32_t y, size_t begin,
+                       size_t end, const QueryRect &rect, const box_t &q,
+                       std::vector<uint32_t> &buffer,
+                       HANDLER_T &handler) const {
+    if (begin == end) {
+      return;
+    }
+    int shift = kMaxLevel - level;
+    uint32_t cell_x_min = x << shift, cell_x_max = ((x + 1) << shift) - 1;
+    uint32_t cell_y_min = y << shift, cell_y_max = ((y + 1) << shift) - 1;
+
+    if (cell_x_min > rect.x_max || cell_x_max < rect.x_min ||
+        cell_y_min > rect.y_max || cell_y_max < rect.y_min) {
+      return;
+    }
+
+    auto kernel = [&](size_t b, size_t e, uint32_t *out) {
+      return simd::FilterIntersects(
+          xmin_.data() + b, ymin_.data() + b, xmax_.data() + b,
+          ymax_.data() + b, e - b, q.min_corner().x(), q.min_corner().y(),
+          q.max_corner().x(), q.max_corner().y(), out);
+    };
+    bool covered = cell_x_min >= rect.x_min && cell_x_max <= rect.x_max &&
+                   cell_y_min >= rect.y_min && cell_y_max <= rect.y_max;
+
+    if (covered || level == kMaxLevel) {
+      // Cells map to the query by rounding, so the boxes are still tested
+      Scan(begin, end, buffer, kernel, handler);
+      return;
+    }
+
+    auto code = Morton(cell_x_min, cell_y_min);
+    uint64_t child_span = 1ull << (2 * (shift - 1));
+    auto own_end = LowerBound(begin, end, MakeKey(code, level + 1));
+
+    Scan(begin, own_end, buffer, kernel, handler);
+
+    size_t child_begin = own_end;
+    for (uint32_t child = 0; child < 4; child++) {
+      size_t child_end =
+          child == 3 ? end
+                     : LowerBound(child_begin, end,
+                                  MakeKey(code + (child + 1) * child_span, 0));
+
+      uint32_t child_x = (x << 1) | (child & 1);
+      uint32_t child_y = (y << 1) | (child >> 1);
+
+      VisitIntersects(level + 1, child_x, child_y, child_begin, child_end, rect,
+                      q, buffer, handler);
+      child_begin = child_end;
+    }
+  }
+
+  /**
+   * Scans the quadrants on the path from the root to the smallest quadrant
+   * that contains rect.
+   */
+  template <typename KERNEL_T, typename HANDLER_T>
+  void VisitPath(const QueryRect &rect, std::vector<uint32_t> &buffer,
+                 KERNEL_T kernel, HANDLER_T &handler) const {
+    size_t begin = 0, end = keys_.size();
+
+    for (int level = 0; level <= kMaxLevel && begin < end; level++) {
+      int shift = kMaxLevel - level;
+      uint32_t x = rect.x_min >> shift, y = rect.y_min >> shift;
+
+      if ((rect.x_max >> shift) != x || (rect.y_max >> shift) != y) {
+        break;
+      }
+
+      auto code = Morton(x << shift, y << shift);
+      uint64_t span = 1ull << (2 * shift);
+      auto node_begin = LowerBound(begin, end, MakeKey(code, level));
+      auto node_end = LowerBound(node_begin, end, MakeKey(code + span, 0));
+      auto own_end = LowerBound(node_begin, node_end, MakeKey(code, level + 1));
+
+      Scan(node_begin, own_end, buffer, kernel, handler);
+      begin = own_end;
+      end = node_end;
+    }
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_QUADTREE_QUADTREE_H
@@ -0,0 +1,84 @@
+#ifndef SPATIALQUERYBENCHMARK_QUADTREE_WITHIN_DISTANCE_QUERY_H
+#define SPATIALQUERYBENCHMARK_QUADTREE_WITHIN_DISTANCE_QUERY_H
+#include "query/quadtree/quadtree.h"
+#include "query/within_distance.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+#include <mutex>
+#include <thread>
+
+time_stat RunWithinDistanceQueryQuadTree(const std::vector<box_t> &boxes,
+                                         const std::vector<point_t> &queries,
+                                         const BenchmarkConfig &config) {
+  Stopwatch sw;
+  time_stat ts;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  QuadTree tree;
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  std::mutex mu;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    tree.Build(boxes);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  std::cout << "QuadTree Entries " << tree.get_num_entries() << " Memory "
+            << tree.get_memory_bytes() / 1024.0 / 1024 << " MB" << std::endl;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    size_t avg_queries =
+        (ts.num_queries + config.parallelism - 1) / config.parallelism;
+    std::vector<std::thread> threads;
+
+    sw.start();
+    ts.num_results = 0;
+    ts.num_candidates = 0;
+    results.clear();
+    for (int tid = 0; tid < config.parallelism; tid++) {
+      threads.emplace_back(
+          [&](int tid) {
+            auto begin = std::min(tid * avg_queries, ts.num_queries);
+            auto end = std::min(begin + avg_queries, ts.num_queries);
+            std::vector<std::pair<uint32_t, uint32_t>> local_results;
+            std::vector<uint32_t> buffer;
+            DistanceRefiner refiner;
+            size_t num_candidates = 0;
+
+            for (auto i = begin; i < end; i++) {
+              auto &p = queries[i];
+
+              refiner.Clear();
+              tree.QueryIntersects(ExpandBox(p, config.distance), buffer,
+                                   [&](uint32_t geom_id) {
+                                     refiner.Add(geom_id, boxes[geom_id]);
+                                   });
+              num_candidates += refiner.size();
+              refiner.Refine(box_t(p, p), config.distance, [&](uint32_t id) {
+                local_results.emplace_back(id, i);
+              });
+            }
+
+            std::unique_lock<std::mutex> lock(mu);
+            results.insert(results.end(), local_results.begin(),
+                           local_results.end());
+            ts.num_candidates += num_candidates;
+          },
+          tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ts.num_results = results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+
+  ts.results = std::move(results);
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_QUADTREE_WITHIN_DISTANCE_QUERY_H
@@ -2,15 +2,44 @@
 #include <iostream>
 
 #include "benchmark_configs.h"
+#include "query/artree/range_count_query.h"
+#include "query/boost/knn_query.h"
 #include "query/boost/point_query.h"
 #include "query/boost/range_query.h"
 #include "query/boost/update.h"
+#include "query/boost/within_distance_query.h"
 #include "query/cgal/point_query.h"
+#include "query/cgal/range_query.h"
+#include "query/cgal/within_distance_query.h"
+#include "query/geos/refine.h"
 #include "query/glin/range_query.h"
+#include "query/grid/point_query.h"
+#include "query/grid/range_query.h"
+#include "query/grid/within_distance_query.h"
+#include "query/group.h"
+#include "query/knn.h"
+#include "query/lbvh_cpu/knn_query.h"
+#include "query/lbvh_cpu/point_query.h"
+#include "query/lbvh_cpu/range_query.h"
+#include "query/lbvh_cpu/within_distance_query.h"
 #include "query/pargeo/point_query.h"
+#include "query/pargeo/range_query.h"
+#include "query/pargeo/update.h"
+#include "query/pargeo/within_distance_query.h"
+#include "query/pbsm/join.h"
+#include "query/quadtree/point_query.h"
+#include "query/quadtree/range_query.h"
+#include "query/quadtree/within_distance_query.h"
+#include "query/rtspatial_cpu/point_query.h"
+#include "query/rtspatial_cpu/range_query.h"
+#include "query/refine.h"
+#include "query/rtspatial_cpu/update.h"
+#include "query/sweep/range_query.h"
+#include "reorder.h"
 
 #ifdef USE_GPU
 #include <optix_function_table_definition.h>
+#include "query/lbvh/knn_query.h"
 #include "query/lbvh/point_query.h"
 #include "query/lbvh/range_query.h"
 #include "query/rtspatial/point_query.h"
@@ -40,6 +69,106 @@ double GetAverageTime(const std::vector<double> &times,
   return total_time / config.repeat;
 }
 
+void PrintLatency(std::vector<double> latency_us) {
+  std::sort(latency_us.begin(), latency_us.end());
+
+  auto percentile = [&](double p) {
+    return latency_us[std::min(latency_us.size() - 1,
+                               (size_t)(p * latency_us.size()))];
+  };
+
+  std::cout << "Query Latency p50 " << percentile(0.5) << " us p95 "
+            << percentile(0.95) << " us p99 " << percentile(0.99)
+            << " us max " << latency_us.back() << " us" << std::endl;
+}
+
+time_stat RunRangeQuery(const std::vector<box_t> &boxes,
+                        const std::vector<box_t> &queries,
+                        const BenchmarkConfig &conf) {
+  time_stat ts;
+
+  switch (conf.index_type) {
+  case BenchmarkConfig::IndexType::kCGAL:
+    ts = RunRangeQueryCGAL(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kRTree:
+    ts = RunRangeQueryBoost(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kParGeo:
+    ts = RunRangeQueryParGeo(boxes, queries, conf);
+    break;
+#ifdef USE_GPU
+  case BenchmarkConfig::IndexType::kRTSpatial:
+    ts = RunRangeQueryRTSpatial(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kRTSpatialVaryParallelism:
+    ts = RunRangeQueryRTSpatialVaryParallelism(boxes, queries, conf);
+    break;
+#endif
+  case BenchmarkConfig::IndexType::kGLIN:
+    ts = RunRangeQueryGLIN(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kGrid:
+  case BenchmarkConfig::IndexType::kGridAdaptive:
+    ts = RunRangeQueryGrid(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kQuadTree:
+    ts = RunRangeQueryQuadTree(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kLBVHCPU:
+    ts = RunRangeQueryLBVHCPU(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kRTSpatialCPU:
+    ts = RunRangeQueryRTSpatialCPU(boxes, queries, conf);
+    break;
+  case BenchmarkConfig::IndexType::kSweep:
+    ts = RunRangeQuerySweep(boxes, queries, conf);
+    break;
+#ifdef USE_GPU
+  case BenchmarkConfig::IndexType::kLBVH:
+    ts = RunRangeQueryLBVH(boxes, queries, conf);
+    break;
+#endif
+  default:
+    std::cerr << "Invalid Index Type" << std::endl;
+    abort();
+  }
+  return ts;
+}
+
+void RunRefine(const std::vector<polygon_t> &polygons,
+               const std::vector<box_t> &queries, const BenchmarkConfig &conf,
+               time_stat &ts) {
+  Stopwatch sw;
+
+  switch (conf.refine) {
+  case BenchmarkConfig::RefineType::kExact: {
+    RangeRefiner refiner;
+
+    sw.start();
+    refiner.Build(polygons);
+    sw.stop();
+    std::cout << "Refine Setup Time " << sw.ms() << " ms Memory "
+              << refiner.get_memory_bytes() / 1024.0 / 1024 << " MB"
+              << std::endl;
+    RefineRangeResults(refiner, queries, conf, ts);
+    break;
+  }
+  case BenchmarkConfig::RefineType::kGEOS: {
+    GEOSRangeRefiner refiner;
+
+    sw.start();
+    refiner.Build(polygons);
+    sw.stop();
+    std::cout << "Refine Setup Time " << sw.ms() << " ms" << std::endl;
+    RefineRangeResults(refiner, queries, conf, ts);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
 int main(int argc, char *argv[]) {
   gflags::SetUsageMessage("Usage: ");
   if (argc == 1) {
@@ -51,14 +180,23 @@ int main(int argc, char *argv[]) {
   auto conf = BenchmarkConfig::GetConfig();
 
   time_stat ts;
+  std::vector<uint32_t> query_order;
   auto polygons = LoadPolygons(conf.geom, conf.serialize, conf.limit);
   std::cout << "Loaded polygons " << polygons.size() << std::endl;
   auto boxes = PolygonsToBoxes(polygons);
+  auto geom_order = Reorder(boxes, conf.reorder, "Geometry");
+
+  // Refinement reads the polygons by the ids of the reordered boxes
+  if (conf.refine != BenchmarkConfig::RefineType::kNone &&
+      !geom_order.empty()) {
+    Permute(polygons, geom_order);
+  }
 
   switch (conf.query_type) {
   case BenchmarkConfig::QueryType::kPointContains: {
     auto queries = LoadPoints(conf.query, conf.serialize, conf.limit);
     std::cout << "Loaded queries " << queries.size() << std::endl;
+    query_order = Reorder(queries, conf.reorder_queries, "Query");
 
     switch (conf.index_type) {
     case BenchmarkConfig::IndexType::kCGAL:
@@ -70,6 +208,15 @@ int main(int argc, char *argv[]) {
     case BenchmarkConfig::IndexType::kParGeo:
       ts = RunPointQueryParGeo(boxes, queries, conf);
       break;
+    case BenchmarkConfig::IndexType::kParGeoLogTree:
+      ts = RunPointQueryParGeoDynamic<pargeo_logtree_of>(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kParGeoBHL:
+      ts = RunPointQueryParGeoDynamic<pargeo_bhl_tree_of>(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kParGeoCO:
+      ts = RunPointQueryParGeoDynamic<pargeo_co_tree_of>(boxes, queries, conf);
+      break;
 #ifdef USE_GPU
     case BenchmarkConfig::IndexType::kRTSpatial:
       ts = RunPointQueryRTSpatial(boxes, queries, conf);
@@ -79,6 +226,19 @@ int main(int argc, char *argv[]) {
       std::cout << "Unsupported" << std::endl;
       abort();
       break;
+    case BenchmarkConfig::IndexType::kGrid:
+    case BenchmarkConfig::IndexType::kGridAdaptive:
+      ts = RunPointQueryGrid(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kQuadTree:
+      ts = RunPointQueryQuadTree(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kLBVHCPU:
+      ts = RunPointQueryLBVHCPU(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kRTSpatialCPU:
+      ts = RunPointQueryRTSpatialCPU(boxes, queries, conf);
+      break;
 #ifdef USE_GPU
     case BenchmarkConfig::IndexType::kLBVH:
       ts = RunPointQueryLBVH(boxes, queries, conf);
@@ -95,31 +255,109 @@ int main(int argc, char *argv[]) {
     // PolygonsToBoxes(LoadPolygons(conf.query, conf.serialize, conf.limit));
     auto queries = PolygonsToBoxes(LoadPolygons(conf.query, conf.limit));
     std::cout << "Loaded queries " << queries.size() << std::endl;
+    query_order = Reorder(queries, conf.reorder_queries, "Query");
+
+    ts = RunRangeQuery(boxes, queries, conf);
+    RunRefine(polygons, queries, conf, ts);
+    break;
+  }
+  case BenchmarkConfig::QueryType::kRangeCount:
+  case BenchmarkConfig::QueryType::kRangeCountContained: {
+    auto queries = PolygonsToBoxes(LoadPolygons(conf.query, conf.limit));
+    std::cout << "Loaded queries " << queries.size() << std::endl;
+    query_order = Reorder(queries, conf.reorder_queries, "Query");
+
+    if (conf.index_type == BenchmarkConfig::IndexType::kARTree) {
+      ts = RunRangeCountQueryARTree(boxes, queries, conf);
+    } else if (conf.query_type ==
+               BenchmarkConfig::QueryType::kRangeCountContained) {
+      // No other backend lists the boxes inside a window
+      std::cerr << "range-count-contained needs -index_type artree"
+                << std::endl;
+      abort();
+    } else {
+      // Enumerates the intersecting boxes and counts them
+      auto count_conf = conf;
+
+      count_conf.query_type = BenchmarkConfig::QueryType::kRangeIntersects;
+      ts = RunRangeQuery(boxes, queries, count_conf);
+    }
+    break;
+  }
+  case BenchmarkConfig::QueryType::kJoin: {
+    auto queries = PolygonsToBoxes(LoadPolygons(conf.query, conf.limit));
+    std::cout << "Loaded queries " << queries.size() << std::endl;
+    query_order = Reorder(queries, conf.reorder_queries, "Query");
+
+    if (conf.index_type == BenchmarkConfig::IndexType::kPBSM) {
+      ts = RunJoinPBSM(boxes, queries, conf);
+    } else {
+      // Index nested loop, the index is built on -geom and probed by every
+      // box of -query
+      auto inl_conf = conf;
+
+      inl_conf.query_type = BenchmarkConfig::QueryType::kRangeIntersects;
+      ts = RunRangeQuery(boxes, queries, inl_conf);
+    }
+    break;
+  }
+  case BenchmarkConfig::QueryType::kKNN: {
+    auto queries = LoadPoints(conf.query, conf.serialize, conf.limit);
+    std::cout << "Loaded queries " << queries.size() << std::endl;
+    query_order = Reorder(queries, conf.reorder_queries, "Query");
 
     switch (conf.index_type) {
     case BenchmarkConfig::IndexType::kRTree:
-      ts = RunRangeQueryBoost(boxes, queries, conf);
-      break;
-#ifdef USE_GPU
-    case BenchmarkConfig::IndexType::kRTSpatial:
-      ts = RunRangeQueryRTSpatial(boxes, queries, conf);
+      ts = RunKNNQueryBoost(boxes, queries, conf);
       break;
-    case BenchmarkConfig::IndexType::kRTSpatialVaryParallelism:
-      ts = RunRangeQueryRTSpatialVaryParallelism(boxes, queries, conf);
-      break;
-#endif
-    case BenchmarkConfig::IndexType::kGLIN:
-      ts = RunRangeQueryGLIN(boxes, queries, conf);
+    case BenchmarkConfig::IndexType::kLBVHCPU:
+      ts = RunKNNQueryLBVHCPU(boxes, queries, conf);
       break;
 #ifdef USE_GPU
     case BenchmarkConfig::IndexType::kLBVH:
-      ts = RunRangeQueryLBVH(boxes, queries, conf);
+      ts = RunKNNQueryLBVH(boxes, queries, conf);
       break;
 #endif
     default:
       std::cerr << "Invalid Index Type" << std::endl;
       abort();
     }
+
+    // Before the ids are restored, they refer to the boxes and queries here
+    if (conf.check) {
+      CheckKNN(boxes, queries, conf.k, ts.results);
+    }
+    break;
+  }
+  case BenchmarkConfig::QueryType::kWithinDistance: {
+    auto queries = LoadPoints(conf.query, conf.serialize, conf.limit);
+    std::cout << "Loaded queries " << queries.size() << std::endl;
+    query_order = Reorder(queries, conf.reorder_queries, "Query");
+
+    switch (conf.index_type) {
+    case BenchmarkConfig::IndexType::kCGAL:
+      ts = RunWithinDistanceQueryCGAL(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kRTree:
+      ts = RunWithinDistanceQueryBoost(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kParGeo:
+      ts = RunWithinDistanceQueryParGeo(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kGrid:
+    case BenchmarkConfig::IndexType::kGridAdaptive:
+      ts = RunWithinDistanceQueryGrid(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kQuadTree:
+      ts = RunWithinDistanceQueryQuadTree(boxes, queries, conf);
+      break;
+    case BenchmarkConfig::IndexType::kLBVHCPU:
+      ts = RunWithinDistanceQueryLBVHCPU(boxes, queries, conf);
+      break;
+    default:
+      std::cerr << "Invalid Index Type" << std::endl;
+      abort();
+    }
     break;
   }
   case BenchmarkConfig::QueryType::kInsertion: {
@@ -129,6 +367,21 @@ int main(int argc, char *argv[]) {
       ts = RunInsertionRTSpatial(boxes, conf);
       break;
 #endif
+    case BenchmarkConfig::IndexType::kParGeoLogTree:
+      ts = RunInsertionParGeo<pargeo_logtree_t>(boxes, conf);
+      break;
+    case BenchmarkConfig::IndexType::kParGeoBHL:
+      ts = RunInsertionParGeo<pargeo_bhl_tree_t>(boxes, conf);
+      break;
+    case BenchmarkConfig::IndexType::kParGeoCO:
+      ts = RunInsertionParGeo<pargeo_co_tree_t>(boxes, conf);
+      break;
+    case BenchmarkConfig::IndexType::kRTSpatialCPU:
+      ts = RunInsertionRTSpatialCPU(boxes, conf);
+      break;
+    default:
+      std::cerr << "Invalid Index Type" << std::endl;
+      abort();
     }
     break;
   }
@@ -139,6 +392,21 @@ int main(int argc, char *argv[]) {
       ts = RunDeletionRTSpatial(boxes, conf);
       break;
 #endif
+    case BenchmarkConfig::IndexType::kParGeoLogTree:
+      ts = RunDeletionParGeo<pargeo_logtree_t>(boxes, conf);
+      break;
+    case BenchmarkConfig::IndexType::kParGeoBHL:
+      ts = RunDeletionParGeo<pargeo_bhl_tree_t>(boxes, conf);
+      break;
+    case BenchmarkConfig::IndexType::kParGeoCO:
+      ts = RunDeletionParGeo<pargeo_co_tree_t>(boxes, conf);
+      break;
+    case BenchmarkConfig::IndexType::kRTSpatialCPU:
+      ts = RunDeletionRTSpatialCPU(boxes, conf);
+      break;
+    default:
+      std::cerr << "Invalid Index Type" << std::endl;
+      abort();
     }
     break;
   }
@@ -147,6 +415,13 @@ int main(int argc, char *argv[]) {
     abort();
   }
 
+  RestoreIds(ts.results, geom_order, query_order);
+
+  // Grouped by the original query ids
+  if (conf.csr) {
+    GroupResults(conf, ts);
+  }
+
   if (!ts.insert_ms.empty()) {
     std::cout << "Loading Time " << GetAverageTime(ts.insert_ms, conf) << " ms"
               << std::endl;
@@ -164,6 +439,25 @@ int main(int argc, char *argv[]) {
                   << std::endl;
       }
     }
+    if (!ts.query_latency_us.empty()) {
+      PrintLatency(ts.query_latency_us);
+    }
+    if (ts.num_candidates > 0) {
+      std::cout << "Filter Candidates " << ts.num_candidates << std::endl;
+    }
+    if (!ts.refine_ms.empty()) {
+      std::cout << "Refine Time " << GetAverageTime(ts.refine_ms, conf)
+                << " ms" << std::endl;
+    }
+    if (!ts.group_ms.empty()) {
+      std::cout << "Group Time " << GetAverageTime(ts.group_ms, conf)
+                << " ms Memory "
+                << (ts.result_offsets.size() * sizeof(size_t) +
+                    ts.result_geoms.size() * sizeof(uint32_t) +
+                    ts.group_scratch_bytes) /
+                       1024.0 / 1024
+                << " MB" << std::endl;
+    }
     std::cout << "Results " << ts.num_results << std::endl;
     std::cout << "Selectivity: "
               << (double)ts.num_results / (ts.num_queries * ts.num_geoms)
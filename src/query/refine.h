@@ -0,0 +1,102 @@
+#ifndef SPATIALQUERYBENCHMARK_QUERY_REFINE_H
+#define SPATIALQUERYBENCHMARK_QUERY_REFINE_H
+#include "benchmark_configs.h"
+#include "geom_common.h"
+#include "query/pip_cpu/polygons.h"
+#include "simd.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+
+#include "parlay/primitives.h"
+
+#include <iostream>
+#include <vector>
+
+/**
+ * Exact polygon-window tests on the flattened polygons. A window that no edge
+ * reaches lies entirely inside or entirely outside the polygon, so after the
+ * SIMD segment-box pass over the rings one crossing test decides.
+ */
+class RangeRefiner {
+public:
+  void Build(const std::vector<polygon_t> &polygons) { flat_.Build(polygons); }
+
+  bool Intersects(uint32_t polygon_id, const box_t &q) const {
+    coord_t q_xmin = q.min_corner().x(), q_ymin = q.min_corner().y();
+    coord_t q_xmax = q.max_corner().x(), q_ymax = q.max_corner().y();
+
+    if (flat_.AnyRing(polygon_id, [&](const coord_t *x, const coord_t *y,
+                                      size_t n) {
+          return simd::AnySegmentIntersects<false>(x, y, n, q_xmin, q_ymin,
+                                                   q_xmax, q_ymax);
+        })) {
+      return true;
+    }
+    return flat_.Contains(polygon_id, q.min_corner());
+  }
+
+  /**
+   * As with Boost's within, a degenerate window is never contained. Edges may
+   * run along the border of the window but not through it.
+   */
+  bool Contains(uint32_t polygon_id, const box_t &q) const {
+    coord_t q_xmin = q.min_corner().x(), q_ymin = q.min_corner().y();
+    coord_t q_xmax = q.max_corner().x(), q_ymax = q.max_corner().y();
+
+    if (q_xmin >= q_xmax || q_ymin >= q_ymax) {
+      return false;
+    }
+    if (flat_.AnyRing(polygon_id, [&](const coord_t *x, const coord_t *y,
+                                      size_t n) {
+          return simd::AnySegmentIntersects<true>(x, y, n, q_xmin, q_ymin,
+                                                  q_xmax, q_ymax);
+        })) {
+      return false;
+    }
+    return flat_.Contains(polygon_id, point_t((q_xmin + q_xmax) / 2,
+                                              (q_ymin + q_ymax) / 2));
+  }
+
+  size_t get_memory_bytes() const { return flat_.get_memory_bytes(); }
+
+private:
+  FlatPolygons flat_;
+};
+
+/**
+ * Replaces the MBR matches of a range query with the pairs whose polygon
+ * passes the exact test. ts.results holds the (geom_id, query_id) candidates
+ * from the filter, with ids referring to polygons and windows. Refinement is
+ * timed on its own and kept out of the query time.
+ */
+template <typename REFINER_T>
+void RefineRangeResults(const REFINER_T &refiner,
+                        const std::vector<box_t> &windows,
+                        const BenchmarkConfig &config, time_stat &ts) {
+  if (ts.results.size() != ts.num_results) {
+    std::cerr << "Refinement needs a backend that reports ids" << std::endl;
+    abort();
+  }
+  bool contains =
+      config.query_type == BenchmarkConfig::QueryType::kRangeContains;
+  Stopwatch sw;
+  parlay::sequence<std::pair<uint32_t, uint32_t>> refined;
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    sw.start();
+    refined = parlay::filter(ts.results, [&](const auto &result) {
+      auto &q = windows[result.second];
+
+      return contains ? refiner.Contains(result.first, q)
+                      : refiner.Intersects(result.first, q);
+    });
+    sw.stop();
+    ts.refine_ms.push_back(sw.ms());
+  }
+
+  ts.num_candidates = ts.results.size();
+  ts.results.assign(refined.begin(), refined.end());
+  ts.num_results = ts.results.size();
+}
+
+#endif // SPATIALQUERYBENCHMARK_QUERY_REFINE_H
@@ -134,6 +134,7 @@ time_stat RunPIPQueryRTSpatial(const std::vector<polygon_t> &polygons,
     sw.stop();
     ts.query_ms.push_back(sw.ms());
   }
+  CopyResults(results, ts.results, stream.cuda_stream());
 
   return ts;
 }
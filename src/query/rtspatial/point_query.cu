@@ -46,7 +46,7 @@ time_stat RunPointQueryRTSpatial(const std::vector<box_t> &boxes,
     ts.insert_ms.push_back(sw.ms());
   }
 
-  auto updates = GenerateUpdates(boxes, config.update_ratio);
+  auto updates = CopyUpdates(GenerateUpdates(boxes, config.update_ratio));
 
   auto run_queries = [&](std::vector<double> &running_times) {
     for (int i = 0; i < config.warmup + config.repeat; i++) {
@@ -89,5 +89,6 @@ time_stat RunPointQueryRTSpatial(const std::vector<box_t> &boxes,
   }
 
   run_queries(ts.query_ms);
+  CopyResults(results, ts.results, stream.cuda_stream());
   return ts;
 }
\ No newline at end of file
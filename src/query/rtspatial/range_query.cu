@@ -56,7 +56,7 @@ time_stat RunRangeQueryRTSpatial(const std::vector<box_t> &boxes,
 
   index.PrintMemoryUsage();
 
-  auto updates = GenerateUpdates(boxes, config.update_ratio);
+  auto updates = CopyUpdates(GenerateUpdates(boxes, config.update_ratio));
 
   auto run_queries = [&](std::vector<double> &running_times) {
     for (int i = 0; i < config.warmup + config.repeat; i++) {
@@ -104,6 +104,7 @@ time_stat RunRangeQueryRTSpatial(const std::vector<box_t> &boxes,
   }
 
   run_queries(ts.query_ms);
+  CopyResults(results, ts.results, stream.cuda_stream());
 
   return ts;
 }
@@ -0,0 +1,77 @@
+#ifndef SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_PIP_HANDLER_H
+#define SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_PIP_HANDLER_H
+#include "query/rtspatial_cpu/spatial_index.h"
+
+#include <cstdint>
+#include <vector>
+/*
+ * Copyright (c) 1970-2003, Wm. Randolph Franklin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimers. Redistributions in binary form must
+reproduce the above copyright notice in the documentation and/or other materials
+provided with the distribution. The name of W. Randolph Franklin may not be used
+to endorse or promote products derived from this Software without specific prior
+written permission. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO
+EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+struct PIPVertex {
+  float x, y;
+};
+
+inline int pnpoly(int nvert, const PIPVertex *vert, float testx, float testy) {
+  int i, j, c = 0;
+  for (i = 0, j = nvert - 1; i < nvert; j = i++) {
+    if (((vert[i].y > testy) != (vert[j].y > testy)) &&
+        (testx < (vert[j].x - vert[i].x) * (testy - vert[i].y) /
+                         (vert[j].y - vert[i].y) +
+                     vert[i].x))
+      c = !c;
+  }
+  return c;
+}
+
+/**
+ * Same layout as PIPContext on the GPU. Polygon i owns
+ * vertices[row_offsets[i], row_offsets[i + 1]), its rings separated by (0, 0)
+ * so a single pnpoly pass handles the holes.
+ */
+struct PIPContextCPU {
+  std::vector<uint32_t> row_offsets;
+  std::vector<PIPVertex> vertices;
+
+  const std::vector<point_t> *points;
+  rtspatial_cpu::Queue<std::pair<uint32_t, uint32_t>> results;
+};
+
+struct PIPHandler {
+  static void HandlePointContains(uint32_t geom_id, uint32_t query_id,
+                                  void *arg) {
+    auto *ctx = static_cast<PIPContextCPU *>(arg);
+    auto &p = (*ctx->points)[query_id];
+    auto begin = ctx->row_offsets[geom_id];
+    auto end = ctx->row_offsets[geom_id + 1];
+
+    if (pnpoly(end - begin, ctx->vertices.data() + begin, p.x(), p.y())) {
+      ctx->results.Append(std::make_pair(geom_id, query_id));
+    }
+  }
+
+  static void HandleEnvelopeContains(uint32_t, uint32_t, void *) {}
+
+  static void HandleEnvelopeIntersects(uint32_t, uint32_t, void *) {}
+};
+
+#endif // SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_PIP_HANDLER_H
@@ -0,0 +1,95 @@
+#ifndef SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_PIP_QUERY_H
+#define SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_PIP_QUERY_H
+#include "query/rtspatial_cpu/pip_handler.h"
+#include "query/rtspatial_cpu/spatial_index.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+
+#include <limits>
+
+time_stat RunPIPQueryRTSpatialCPU(const std::vector<polygon_t> &polygons,
+                                  const std::vector<point_t> &points,
+                                  const BenchmarkConfig &config) {
+  std::vector<box_t> boxes(polygons.size());
+  PIPContextCPU ctx;
+  uint32_t tail = 0;
+
+  ctx.row_offsets.push_back(tail);
+
+  for (size_t i = 0; i < boxes.size(); i++) {
+    const auto &polygon = polygons[i];
+    coord_t lows[2] = {std::numeric_limits<coord_t>::max(),
+                       std::numeric_limits<coord_t>::max()};
+    coord_t highs[2] = {std::numeric_limits<coord_t>::lowest(),
+                        std::numeric_limits<coord_t>::lowest()};
+
+    for (auto &p : polygon.outer()) {
+      lows[0] = std::min(lows[0], p.x());
+      highs[0] = std::max(highs[0], p.x());
+      lows[1] = std::min(lows[1], p.y());
+      highs[1] = std::max(highs[1], p.y());
+    }
+
+    boxes[i] = box_t(point_t(lows[0], lows[1]), point_t(highs[0], highs[1]));
+
+    // https://wrfranklin.org/Research/Short_Notes/pnpoly.html
+    ctx.vertices.push_back(PIPVertex{0, 0});
+    tail++;
+
+    for (auto &p : polygon.outer()) {
+      ctx.vertices.push_back(PIPVertex{p.x(), p.y()});
+      tail++;
+    }
+    ctx.vertices.push_back(PIPVertex{0, 0});
+    tail++;
+
+    // fill holes
+    for (auto &inner : polygon.inners()) {
+      for (auto &p : inner) {
+        ctx.vertices.push_back(PIPVertex{p.x(), p.y()});
+        tail++;
+      }
+      ctx.vertices.push_back(PIPVertex{0, 0});
+      tail++;
+    }
+    ctx.row_offsets.push_back(tail);
+  }
+
+  rtspatial_cpu::SpatialIndex<PIPHandler> index;
+  rtspatial_cpu::Config idx_config;
+
+  idx_config.max_geometries = boxes.size();
+
+  index.Init(idx_config);
+  time_stat ts;
+  Stopwatch sw;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = points.size();
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    index.Clear();
+    sw.start();
+    index.Insert(boxes);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  ctx.points = &points;
+  ctx.results.Init(std::max(
+      1ul, (size_t)(ts.num_geoms * ts.num_queries * config.load_factor)));
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    ctx.results.Clear();
+    sw.start();
+    index.Query(rtspatial_cpu::Predicate::kContains, points, &ctx);
+    ts.num_results = ctx.results.size();
+    sw.stop();
+    ts.query_ms.push_back(sw.ms());
+  }
+  ts.results.assign(ctx.results.data(),
+                    ctx.results.data() + ctx.results.size());
+
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_PIP_QUERY_H
@@ -0,0 +1,74 @@
+#ifndef SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_POINT_QUERY_H
+#define SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_POINT_QUERY_H
+#include "query/rtspatial_cpu/spatial_index.h"
+#include "query/updates.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+
+time_stat RunPointQueryRTSpatialCPU(const std::vector<box_t> &boxes,
+                                    const std::vector<point_t> &queries,
+                                    const BenchmarkConfig &config) {
+  rtspatial_cpu::SpatialIndex<rtspatial_cpu::CollectingHandler> index;
+  rtspatial_cpu::Config idx_config;
+
+  idx_config.max_geometries = boxes.size();
+
+  index.Init(idx_config);
+  time_stat ts;
+  Stopwatch sw;
+
+  ts.num_geoms = boxes.size();
+  ts.num_queries = queries.size();
+
+  rtspatial_cpu::Queue<std::pair<uint32_t, uint32_t>> results;
+
+  results.Init(std::max(
+      1ul, (size_t)(boxes.size() * queries.size() * config.load_factor)));
+
+  for (int i = 0; i < config.warmup + config.repeat; i++) {
+    index.Clear();
+    sw.start();
+    index.Insert(boxes);
+    sw.stop();
+    ts.insert_ms.push_back(sw.ms());
+  }
+
+  auto updates = GenerateUpdates(boxes, config.update_ratio);
+
+  auto run_queries = [&](std::vector<double> &running_times) {
+    for (int i = 0; i < config.warmup + config.repeat; i++) {
+      results.Clear();
+      sw.start();
+      switch (config.query_type) {
+      case BenchmarkConfig::QueryType::kPointContains: {
+        index.Query(rtspatial_cpu::Predicate::kContains, queries, &results);
+        break;
+      }
+      default:
+        abort();
+      }
+      ts.num_results = results.size();
+      sw.stop();
+      running_times.push_back(sw.ms());
+    }
+  };
+
+  if (!updates.empty()) {
+    auto updated_boxes = boxes;
+
+    index.Update(updates);
+
+    // Run Query after updates
+    run_queries(ts.query_ms_after_update);
+
+    ApplyUpdates(updated_boxes, updates);
+    // Rebuild Index on updated geometries
+    index.Clear();
+    index.Insert(updated_boxes);
+  }
+
+  run_queries(ts.query_ms);
+  ts.results.assign(results.data(), results.data() + results.size());
+  return ts;
+}
+#endif // SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_POINT_QUERY_H
@@ -0,0 +1,227 @@
+#ifndef SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_SPATIAL_INDEX_H
+#define SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_SPATIAL_INDEX_H
+#include "geom_common.h"
+#include "query/lbvh_cpu/lbvh.h"
+
+#include "parlay/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/**
+ * A multi-threaded CPU counterpart of rtspatial::SpatialIndex with the same
+ * calls: Init, Insert, Delete, Update, Clear and Query. Every Insert builds a
+ * LinearBVH over its batch, as RTSpatial builds one GAS per batch. Ids are
+ * assigned in insertion order across batches, Delete hides ids and Update
+ * overwrites boxes and refits the batches it touched.
+ *
+ * Results go through the handler contract of RTSpatial. HANDLER_T provides
+ * static HandlePointContains, HandleEnvelopeContains and
+ * HandleEnvelopeIntersects, each taking (geom_id, query_id, arg) like the
+ * rtspatial_handle_* callbacks, and is called concurrently from the query
+ * threads.
+ */
+namespace rtspatial_cpu {
+
+enum class Predicate { kContains, kIntersects };
+
+struct Config {
+  size_t max_geometries = 0;
+};
+
+/**
+ * A fixed capacity queue that query threads append to, like rtspatial::Queue.
+ */
+template <typename T> class Queue {
+public:
+  void Init(size_t capacity) {
+    data_.resize(capacity);
+    tail_ = 0;
+  }
+
+  void Append(const T &item) {
+    auto idx = tail_.fetch_add(1, std::memory_order_relaxed);
+
+    if (idx >= data_.size()) {
+      std::cerr << "Queue overflows, capacity " << data_.size()
+                << ", increase -load_factor" << std::endl;
+      abort();
+    }
+    data_[idx] = item;
+  }
+
+  void Clear() { tail_ = 0; }
+
+  size_t size() const { return tail_; }
+
+  const T *data() const { return data_.data(); }
+
+private:
+  std::vector<T> data_;
+  std::atomic<size_t> tail_{0};
+};
+
+template <typename HANDLER_T> class SpatialIndex {
+public:
+  void Init(const Config &config) {
+    Clear();
+    boxes_.reserve(config.max_geometries);
+    deleted_.reserve(config.max_geometries);
+  }
+
+  void Insert(const std::vector<box_t> &boxes) {
+    Insert(boxes.data(), boxes.size());
+  }
+
+  void Insert(const box_t *boxes, size_t n) {
+    if (n == 0) {
+      return;
+    }
+    size_t begin = boxes_.size();
+
+    boxes_.insert(boxes_.end(), boxes, boxes + n);
+    deleted_.resize(boxes_.size(), 0);
+    batches_.emplace_back();
+
+    auto &batch = batches_.back();
+
+    batch.begin = begin;
+    batch.bvh.Build(boxes_.data() + begin, n);
+  }
+
+  void Delete(const std::vector<size_t> &ids) {
+    parlay::parallel_for(0, ids.size(), [&](size_t i) {
+      deleted_[ids[i]] = 1;
+    });
+  }
+
+  void Update(const std::vector<std::pair<size_t, box_t>> &updates) {
+    std::vector<uint8_t> dirty(batches_.size(), 0);
+
+    for (auto &update : updates) {
+      boxes_[update.first] = update.second;
+      dirty[FindBatch(update.first)] = 1;
+    }
+
+    for (size_t i = 0; i < batches_.size(); i++) {
+      if (dirty[i]) {
+        batches_[i].bvh.Refit(boxes_.data() + batches_[i].begin);
+      }
+    }
+  }
+
+  void Clear() {
+    boxes_.clear();
+    deleted_.clear();
+    batches_.clear();
+  }
+
+  void Query(Predicate pred, const std::vector<point_t> &queries,
+             void *arg) const {
+    if (pred != Predicate::kContains) {
+      std::cerr << "Points only support the contains predicate" << std::endl;
+      abort();
+    }
+    parlay::parallel_for(0, queries.size(), [&](size_t query_id) {
+      ForEach(query_id, [&](const LinearBVH &bvh, auto handler) {
+        bvh.QueryContains(queries[query_id], handler);
+      }, HANDLER_T::HandlePointContains, arg);
+    });
+  }
+
+  void Query(Predicate pred, const std::vector<box_t> &queries,
+             void *arg) const {
+    parlay::parallel_for(0, queries.size(), [&](size_t query_id) {
+      auto &q = queries[query_id];
+
+      switch (pred) {
+      case Predicate::kContains:
+        ForEach(query_id, [&](const LinearBVH &bvh, auto handler) {
+          bvh.QueryContains(q, handler);
+        }, HANDLER_T::HandleEnvelopeContains, arg);
+        break;
+      case Predicate::kIntersects:
+        ForEach(query_id, [&](const LinearBVH &bvh, auto handler) {
+          bvh.QueryIntersects(q, handler);
+        }, HANDLER_T::HandleEnvelopeIntersects, arg);
+        break;
+      }
+    });
+  }
+
+  size_t get_num_geometries() const { return boxes_.size(); }
+
+  void PrintMemoryUsage() const {
+    size_t bytes = boxes_.size() * (sizeof(box_t) + sizeof(uint8_t));
+
+    for (auto &batch : batches_) {
+      bytes += batch.bvh.get_memory_bytes();
+    }
+    std::cout << "Batches " << batches_.size() << " Memory "
+              << bytes / 1024.0 / 1024 << " MB" << std::endl;
+  }
+
+private:
+  struct Batch {
+    size_t begin;
+    LinearBVH bvh;
+  };
+
+  std::vector<box_t> boxes_;
+  std::vector<uint8_t> deleted_;
+  std::vector<Batch> batches_;
+
+  size_t FindBatch(size_t geom_id) const {
+    auto it = std::upper_bound(
+        batches_.begin(), batches_.end(), geom_id,
+        [](size_t id, const Batch &batch) { return id < batch.begin; });
+    return it - batches_.begin() - 1;
+  }
+
+  template <typename VISIT_T, typename CALLBACK_T>
+  void ForEach(size_t query_id, VISIT_T visit, CALLBACK_T callback,
+               void *arg) const {
+    for (auto &batch : batches_) {
+      visit(batch.bvh, [&](uint32_t local_id) {
+        auto geom_id = batch.begin + local_id;
+
+        if (!deleted_[geom_id]) {
+          callback(geom_id, query_id, arg);
+        }
+      });
+    }
+  }
+};
+
+/**
+ * Counterpart of RTSpatial's collecting handlers, arg is a
+ * Queue<std::pair<uint32_t, uint32_t>> receiving (geom_id, query_id).
+ */
+struct CollectingHandler {
+  static void Collect(uint32_t geom_id, uint32_t query_id, void *arg) {
+    static_cast<Queue<std::pair<uint32_t, uint32_t>> *>(arg)->Append(
+        std::make_pair(geom_id, query_id));
+  }
+
+  static void HandlePointContains(uint32_t geom_id, uint32_t query_id,
+                                  void *arg) {
+    Collect(geom_id, query_id, arg);
+  }
+
+  static void HandleEnvelopeContains(uint32_t geom_id, uint32_t query_id,
+                                     void *arg) {
+    Collect(geom_id, query_id, arg);
+  }
+
+  static void HandleEnvelopeIntersects(uint32_t geom_id, uint32_t query_id,
+                                       void *arg) {
+    Collect(geom_id, query_id, arg);
+  }
+};
+
+} // namespace rtspatial_cpu
+
+#endif // SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_SPATIAL_INDEX_H
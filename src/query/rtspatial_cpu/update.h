@@ -0,0 +1,152 @@
+#ifndef SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_UPDATE_H
+#define SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_UPDATE_H
+#include "query/rtspatial_cpu/spatial_index.h"
+#include "stopwatch.h"
+#include "time_stat.h"
+
+#include <numeric>
+
+time_stat RunInsertionRTSpatialCPU(const std::vector<box_t> &boxes,
+                                   const BenchmarkConfig &config) {
+  rtspatial_cpu::SpatialIndex<rtspatial_cpu::CollectingHandler> index;
+  rtspatial_cpu::Config idx_config;
+
+  idx_config.max_geometries = boxes.size();
+
+  index.Init(idx_config);
+  time_stat ts;
+  Stopwatch sw;
+
+  ts.num_geoms = boxes.size();
+
+  int batch = config.batch;
+
+  if (batch == -1) {
+    size_t n_steps = 100;
+    size_t avg_gemos_per_step = (boxes.size() + n_steps - 1) / n_steps;
+    size_t n_inserted = 0;
+
+    for (size_t i = 0; i < n_steps; i++) {
+      auto begin = i * avg_gemos_per_step;
+      auto size = std::min(begin + avg_gemos_per_step, boxes.size()) - begin;
+      double total_insert_time = 0;
+
+      n_inserted += size;
+
+      for (int repeat = 0; repeat < config.repeat; repeat++) {
+        index.Clear();
+
+        sw.start();
+        index.Insert(boxes.data(), n_inserted);
+        sw.stop();
+        total_insert_time += sw.ms();
+      }
+
+      std::cout << "Step " << i << " Geoms " << n_inserted << " Insert Time "
+                << total_insert_time / config.repeat << " ms" << std::endl;
+    }
+  } else {
+    double total_insert_time = 0;
+    size_t n_batches = (boxes.size() + batch - 1) / batch;
+
+    for (int repeat = 0; repeat < config.repeat; repeat++) {
+      index.Clear();
+
+      sw.start();
+      for (size_t batch_id = 0; batch_id < n_batches; batch_id++) {
+        size_t batch_begin = batch_id * batch;
+        size_t batch_size =
+            std::min(batch_begin + batch, boxes.size()) - batch_begin;
+
+        index.Insert(boxes.data() + batch_begin, batch_size);
+      }
+      sw.stop();
+      total_insert_time += sw.ms();
+    }
+    total_insert_time /= config.repeat;
+
+    std::cout << "Batch " << batch << " Geoms " << boxes.size()
+              << " Insert Time " << total_insert_time << " ms Throughput "
+              << boxes.size() / (total_insert_time / 1000) << " geoms/sec"
+              << std::endl;
+  }
+  return ts;
+}
+
+time_stat RunDeletionRTSpatialCPU(const std::vector<box_t> &boxes,
+                                  const BenchmarkConfig &config) {
+  rtspatial_cpu::SpatialIndex<rtspatial_cpu::CollectingHandler> index;
+  std::vector<size_t> deleted_ids;
+  rtspatial_cpu::Config idx_config;
+
+  idx_config.max_geometries = boxes.size();
+
+  index.Init(idx_config);
+  time_stat ts;
+  Stopwatch sw;
+
+  ts.num_geoms = boxes.size();
+
+  int batch = config.batch;
+
+  if (batch == -1) {
+    size_t n_steps = 100;
+    size_t avg_gemos_per_step = (boxes.size() + n_steps - 1) / n_steps;
+    size_t n_inserted = 0;
+
+    for (size_t i = 0; i < n_steps; i++) {
+      auto begin = i * avg_gemos_per_step;
+      auto size = std::min(begin + avg_gemos_per_step, boxes.size()) - begin;
+      double total_delete_time = 0;
+
+      n_inserted += size;
+
+      for (int repeat = 0; repeat < config.repeat; repeat++) {
+        index.Clear();
+        index.Insert(boxes.data(), n_inserted);
+
+        deleted_ids.resize(n_inserted);
+        std::iota(deleted_ids.begin(), deleted_ids.end(), 0);
+
+        sw.start();
+        index.Delete(deleted_ids);
+        sw.stop();
+        total_delete_time += sw.ms();
+      }
+
+      std::cout << "Step " << i << " Geoms " << n_inserted << " Delete Time "
+                << total_delete_time / config.repeat << " ms" << std::endl;
+    }
+  } else {
+    double total_delete_time = 0;
+    size_t n_batches = (boxes.size() + batch - 1) / batch;
+
+    for (int repeat = 0; repeat < config.repeat; repeat++) {
+      index.Clear();
+      index.Insert(boxes);
+
+      for (size_t batch_id = 0; batch_id < n_batches; batch_id++) {
+        size_t batch_begin = batch_id * batch;
+        size_t batch_end = std::min(batch_begin + batch, boxes.size());
+
+        deleted_ids.resize(batch_end - batch_begin);
+        std::iota(deleted_ids.begin(), deleted_ids.end(), batch_begin);
+
+        sw.start();
+        index.Delete(deleted_ids);
+        sw.stop();
+        total_delete_time += sw.ms();
+      }
+    }
+
+    total_delete_time /= config.repeat;
+
+    std::cout << "Batch " << batch << " Geoms " << boxes.size()
+              << " Delete Time " << total_delete_time << " ms Throughput "
+              << boxes.size() / (total_delete_time / 1000) << " geoms/sec"
+              << std::endl;
+  }
+  return ts;
+}
+
+#endif // SPATIALQUERYBENCHMARK_RTSPATIAL_CPU_UPDATE_H
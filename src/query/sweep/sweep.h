@@ -0,0 +1,242 @@
+#ifndef SPATIALQUERYBENCHMARK_SWEEP_SWEEP_H
+#define SPATIALQUERYBENCHMARK_SWEEP_SWEEP_H
+#include "geom_common.h"
+#include "simd.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * Answers a batch of range queries without an index by sorting both the boxes
+ * and the queries by x_min and sweeping them forward. The queries are cut into
+ * strips of equal count that are swept in parallel. Within a strip, the boxes
+ * that start left of the current query and are still open form the active
+ * list, and the boxes that start inside the query are a contiguous run of the
+ * sorted boxes. Both are tested with the SIMD filters over SoA arrays.
+ */
+class PlaneSweep {
+  // Strips per worker, so threads that finish early can take more strips
+  static constexpr size_t kStripsPerWorker = 4;
+  // Closed boxes are dropped from the active list every this many queries
+  static constexpr size_t kCompactInterval = 64;
+
+public:
+  enum class Predicate { kContains, kIntersects };
+
+  /**
+   * Sorts the boxes by x_min, which is the only preparation the sweep needs.
+   */
+  void Prepare(const std::vector<box_t> &boxes) {
+    auto order = SortByXMin(boxes);
+
+    ids_.resize(boxes.size());
+    xmin_.resize(boxes.size());
+    ymin_.resize(boxes.size());
+    xmax_.resize(boxes.size());
+    ymax_.resize(boxes.size());
+
+    parlay::parallel_for(0, boxes.size(), [&](size_t i) {
+      auto &box = boxes[order[i]];
+
+      ids_[i] = order[i];
+      xmin_[i] = box.min_corner().x();
+      ymin_[i] = box.min_corner().y();
+      xmax_[i] = box.max_corner().x();
+      ymax_[i] = box.max_corner().y();
+    });
+  }
+
+  /**
+   * Returns (geom_id, query_id) for every qualifying pair. As with Boost's
+   * within, a degenerate query is never contained.
+   */
+  std::vector<std::pair<uint32_t, uint32_t>>
+  Query(Predicate pred, const std::vector<box_t> &queries) const {
+    if (queries.empty() || ids_.empty()) {
+      return {};
+    }
+    auto order = SortByXMin(queries);
+    size_t n_strips = std::min(queries.size(),
+                               parlay::num_workers() * kStripsPerWorker);
+    size_t strip_size = (queries.size() + n_strips - 1) / n_strips;
+
+    auto strip_results = parlay::tabulate(
+        n_strips,
+        [&](size_t strip) {
+          auto begin = std::min(strip * strip_size, queries.size());
+          auto end = std::min(begin + strip_size, queries.size());
+          std::vector<std::pair<uint32_t, uint32_t>> results;
+
+          SweepStrip(pred, queries, order, begin, end, results);
+          return results;
+        },
+        1);
+    auto flat = parlay::flatten(strip_results);
+
+    return std::vector<std::pair<uint32_t, uint32_t>>(flat.begin(), flat.end());
+  }
+
+  size_t get_memory_bytes() const {
+    return ids_.size() * (sizeof(uint32_t) + 4 * sizeof(coord_t));
+  }
+
+private:
+  std::vector<uint32_t> ids_;
+  std::vector<coord_t> xmin_, ymin_, xmax_, ymax_;
+
+  struct ActiveList {
+    std::vector<uint32_t> pos; // positions in the sorted boxes
+    std::vector<coord_t> xmin, ymin, xmax, ymax;
+
+    void Append(const PlaneSweep &sweep, size_t i) {
+      pos.push_back(i);
+      xmin.push_back(sweep.xmin_[i]);
+      ymin.push_back(sweep.ymin_[i]);
+      xmax.push_back(sweep.xmax_[i]);
+      ymax.push_back(sweep.ymax_[i]);
+    }
+
+    // Keeps the boxes that are still open at x
+    void Compact(coord_t x) {
+      size_t n = 0;
+
+      for (size_t i = 0; i < pos.size(); i++) {
+        if (xmax[i] >= x) {
+          pos[n] = pos[i];
+          xmin[n] = xmin[i];
+          ymin[n] = ymin[i];
+          xmax[n] = xmax[i];
+          ymax[n] = ymax[i];
+          n++;
+        }
+      }
+      pos.resize(n);
+      xmin.resize(n);
+      ymin.resize(n);
+      xmax.resize(n);
+      ymax.resize(n);
+    }
+  };
+
+  static parlay::sequence<uint32_t> SortByXMin(const std::vector<box_t> &b) {
+    auto order =
+        parlay::tabulate(b.size(), [](size_t i) { return (uint32_t)i; });
+
+    parlay::sort_inplace(order, [&](uint32_t i, uint32_t j) {
+      return b[i].min_corner().x() < b[j].min_corner().x();
+    });
+    return order;
+  }
+
+  // First position of the sorted boxes whose x_min is not less than x
+  size_t LowerBound(coord_t x) const {
+    return std::lower_bound(xmin_.begin(), xmin_.end(), x) - xmin_.begin();
+  }
+
+  // First position of the sorted boxes whose x_min is greater than x
+  size_t UpperBound(coord_t x) const {
+    return std::upper_bound(xmin_.begin(), xmin_.end(), x) - xmin_.begin();
+  }
+
+  void SweepStrip(Predicate pred, const std::vector<box_t> &queries,
+                  const parlay::sequence<uint32_t> &order, size_t begin,
+                  size_t end,
+                  std::vector<std::pair<uint32_t, uint32_t>> &results) const {
+    if (begin == end) {
+      return;
+    }
+    ActiveList active;
+    std::vector<uint32_t> buffer;
+    auto lowest = std::numeric_limits<coord_t>::lowest();
+    auto highest = std::numeric_limits<coord_t>::max();
+    auto x0 = queries[order[begin]].min_corner().x();
+    // Boxes left of the strip that reach into it, found by one SIMD pass
+    size_t next = LowerBound(x0);
+
+    buffer.resize(next);
+    auto n_open = simd::FilterIntersects(
+        xmin_.data(), ymin_.data(), xmax_.data(), ymax_.data(), next, x0,
+        lowest, highest, highest, buffer.data());
+    for (size_t i = 0; i < n_open; i++) {
+      active.Append(*this, buffer[i]);
+    }
+
+    for (auto i = begin; i < end; i++) {
+      auto query_id = order[i];
+      auto &q = queries[query_id];
+      coord_t q_xmin = q.min_corner().x(), q_ymin = q.min_corner().y();
+      coord_t q_xmax = q.max_corner().x(), q_ymax = q.max_corner().y();
+
+      // Boxes starting left of the query join the active list
+      for (auto n_left = LowerBound(q_xmin); next < n_left; next++) {
+        active.Append(*this, next);
+      }
+      if ((i - begin) % kCompactInterval == 0) {
+        active.Compact(q_xmin);
+      }
+      if (pred == Predicate::kContains &&
+          (q_xmin >= q_xmax || q_ymin >= q_ymax)) {
+        continue;
+      }
+
+      size_t run_end = 0;
+      size_t n_active = 0, n_run = 0;
+
+      if (buffer.size() < active.pos.size()) {
+        buffer.resize(active.pos.size());
+      }
+
+      switch (pred) {
+      case Predicate::kContains:
+        // Only boxes starting at or before q_xmin can contain the query
+        run_end = UpperBound(q_xmin);
+        n_active = simd::FilterContains(
+            active.xmin.data(), active.ymin.data(), active.xmax.data(),
+            active.ymax.data(), active.pos.size(), q_xmin, q_ymin, q_xmax,
+            q_ymax, buffer.data());
+        break;
+      case Predicate::kIntersects:
+        run_end = UpperBound(q_xmax);
+        n_active = simd::FilterIntersects(
+            active.xmin.data(), active.ymin.data(), active.xmax.data(),
+            active.ymax.data(), active.pos.size(), q_xmin, q_ymin, q_xmax,
+            q_ymax, buffer.data());
+        break;
+      }
+
+      for (size_t k = 0; k < n_active; k++) {
+        results.emplace_back(ids_[active.pos[buffer[k]]], query_id);
+      }
+
+      // Boxes starting inside the query are a contiguous run
+      if (run_end > next) {
+        auto run_begin = next;
+        auto n = run_end - run_begin;
+
+        if (buffer.size() < n) {
+          buffer.resize(n);
+        }
+        if (pred == Predicate::kContains) {
+          n_run = simd::FilterContains(
+              xmin_.data() + run_begin, ymin_.data() + run_begin,
+              xmax_.data() + run_begin, ymax_.data() + run_begin, n, q_xmin,
+              q_ymin, q_xmax, q_ymax, buffer.data());
+        } else {
+          n_run = simd::FilterIntersects(
+              xmin_.data() + run_begin, ymin_.data() + run_begin,
+              xmax_.data() + run_begin, ymax_.data() + run_begin, n, q_xmin,
+              q_ymin, q_xmax, q_ymax, buffer.data());
+        }
+        for (size_t k = 0; k < n_run; k++) {
+          results.emplace_back(ids_[run_begin + buffer[k]], query_id);
+        }
+      }
+    }
+  }
+};
+
+#endif // SPATIALQUERYBENCHMARK_SWEEP_SWEEP_H
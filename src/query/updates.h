@@ -0,0 +1,85 @@
+#ifndef SPATIALQUERYBENCHMARK_QUERY_UPDATES_H
+#define SPATIALQUERYBENCHMARK_QUERY_UPDATES_H
+#include "geom_common.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * Picks update_ratio of the boxes at random and moves, enlarges or shrinks
+ * each of them. The result is a list of (box id, new box), seeded by the
+ * number of boxes so every backend replays the same updates.
+ */
+inline std::vector<std::pair<size_t, box_t>>
+GenerateUpdates(const std::vector<box_t> &boxes, float update_ratio) {
+  size_t n_updates = boxes.size() * update_ratio;
+  if (n_updates == 0) {
+    return {};
+  }
+  std::vector<size_t> updated_ids(boxes.size());
+
+  for (size_t i = 0; i < boxes.size(); i++) {
+    updated_ids[i] = i;
+  }
+
+  std::mt19937 g(boxes.size());
+
+  std::shuffle(updated_ids.begin(), updated_ids.end(), g);
+
+  updated_ids.resize(n_updates);
+
+  std::vector<std::pair<size_t, box_t>> updates;
+
+  for (auto box_id : updated_ids) {
+    auto &box = boxes[box_id];
+    auto width = box.max_corner().x() - box.min_corner().x();
+    auto height = box.max_corner().y() - box.min_corner().x();
+
+    int op = box_id % 3;
+    box_t new_box;
+
+    if (op == 0) { // Move box
+      auto center_x = (box.min_corner().x() + box.max_corner().x()) / 2;
+      auto center_y = (box.min_corner().y() + box.max_corner().y()) / 2;
+      // Move range will not exceed 10x of the extends of the box
+      std::uniform_real_distribution<float> dist_x(center_x - 5 * width,
+                                                   center_x + 5 * width);
+      std::uniform_real_distribution<float> dist_y(center_y - 5 * height,
+                                                   center_y + 5 * height);
+
+      auto min_x = dist_x(g), max_x = min_x + width;
+      auto min_y = dist_y(g), max_y = min_y + height;
+
+      new_box = box_t(point_t(min_x, min_y), point_t(max_x, max_y));
+    } else if (op == 1) { // enlarge
+      std::uniform_real_distribution<float> dist_width(width, width * 10);
+      std::uniform_real_distribution<float> dist_height(height, height * 10);
+      auto min_x = box.min_corner().x(), max_x = min_x + dist_width(g);
+      auto min_y = box.min_corner().y(), max_y = min_y + dist_height(g);
+
+      new_box = box_t(point_t(min_x, min_y), point_t(max_x, max_y));
+    } else { // shrink
+      std::uniform_real_distribution<float> dist_width(0, width);
+      std::uniform_real_distribution<float> dist_height(0, height);
+      auto min_x = box.min_corner().x(), max_x = min_x + dist_width(g);
+      auto min_y = box.min_corner().y(), max_y = min_y + dist_height(g);
+
+      new_box = box_t(point_t(min_x, min_y), point_t(max_x, max_y));
+    }
+
+    updates.emplace_back(box_id, new_box);
+  }
+
+  return updates;
+}
+
+inline void ApplyUpdates(std::vector<box_t> &boxes,
+                         const std::vector<std::pair<size_t, box_t>> &updates) {
+  for (auto &update : updates) {
+    boxes[update.first] = update.second;
+  }
+}
+
+#endif // SPATIALQUERYBENCHMARK_QUERY_UPDATES_H
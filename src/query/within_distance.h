@@ -0,0 +1,73 @@
+#ifndef SPATIALQUERYBENCHMARK_QUERY_WITHIN_DISTANCE_H
+#define SPATIALQUERYBENCHMARK_QUERY_WITHIN_DISTANCE_H
+#include "geom_common.h"
+#include "simd.h"
+
+#include <vector>
+
+/**
+ * Within-distance queries are answered in two steps. The filter finds the
+ * boxes intersecting the query expanded by the distance on every side, which
+ * every backend already supports. The refine step drops the candidates near
+ * the corners of the expanded box, whose exact distance is larger.
+ */
+inline box_t ExpandBox(const box_t &box, double dist) {
+  return box_t(point_t(box.min_corner().x() - dist,
+                       box.min_corner().y() - dist),
+               point_t(box.max_corner().x() + dist,
+                       box.max_corner().y() + dist));
+}
+
+inline box_t ExpandBox(const point_t &p, double dist) {
+  return ExpandBox(box_t(p, p), dist);
+}
+
+/**
+ * Collects the candidates of one query as coordinate arrays, so the exact
+ * distance test runs as one SIMD pass. Reused across queries by a thread.
+ */
+class DistanceRefiner {
+public:
+  void Clear() {
+    ids_.clear();
+    xmin_.clear();
+    ymin_.clear();
+    xmax_.clear();
+    ymax_.clear();
+  }
+
+  void Add(uint32_t id, const box_t &box) {
+    ids_.push_back(id);
+    xmin_.push_back(box.min_corner().x());
+    ymin_.push_back(box.min_corner().y());
+    xmax_.push_back(box.max_corner().x());
+    ymax_.push_back(box.max_corner().y());
+  }
+
+  size_t size() const { return ids_.size(); }
+
+  /**
+   * Calls handler(id) for the candidates within dist of q.
+   */
+  template <typename HANDLER_T>
+  void Refine(const box_t &q, double dist, HANDLER_T handler) {
+    if (out_.size() < ids_.size()) {
+      out_.resize(ids_.size());
+    }
+    auto n = simd::FilterWithinDistance(
+        xmin_.data(), ymin_.data(), xmax_.data(), ymax_.data(), ids_.size(),
+        q.min_corner().x(), q.min_corner().y(), q.max_corner().x(),
+        q.max_corner().y(), (coord_t)(dist * dist), out_.data());
+
+    for (size_t i = 0; i < n; i++) {
+      handler(ids_[out_[i]]);
+    }
+  }
+
+private:
+  std::vector<uint32_t> ids_;
+  std::vector<coord_t> xmin_, ymin_, xmax_, ymax_;
+  std::vector<uint32_t> out_;
+};
+
+#endif // SPATIALQUERYBENCHMARK_QUERY_WITHIN_DISTANCE_H
@@ -0,0 +1,191 @@
+#ifndef SPATIALQUERYBENCHMARK_REORDER_H
+#define SPATIALQUERYBENCHMARK_REORDER_H
+#include "benchmark_configs.h"
+#include "geom_common.h"
+#include "glin/hilbert/hilbert.h"
+#include "stopwatch.h"
+
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Orders geometries so that neighbours in the array are neighbours in space.
+ * Curve orders sort the centres of the geometries by their Morton or Hilbert
+ * key on a 2^16 x 2^16 grid over their bounds. STR sorts the centres into
+ * vertical slabs by x and each slab by y, the order STR bulk loading packs
+ * leaves of leaf_size in, BOOST_LEAF_SIZE unless given. The result is a
+ * permutation, order[i] is the original index of the i-th geometry.
+ */
+namespace detail {
+constexpr int kCurveBits = 16;
+
+inline uint64_t SpreadBits(uint32_t v) {
+  uint64_t x = v;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+  x = (x | (x << 2)) & 0x3333333333333333ull;
+  x = (x | (x << 1)) & 0x5555555555555555ull;
+  return x;
+}
+
+inline point_t Center(const point_t &p) { return p; }
+
+inline point_t Center(const box_t &box) {
+  return point_t((box.min_corner().x() + box.max_corner().x()) / 2,
+                 (box.min_corner().y() + box.max_corner().y()) / 2);
+}
+
+inline point_t Center(const polygon_t &polygon) {
+  return Center(boost::geometry::return_envelope<box_t>(polygon));
+}
+
+inline std::vector<uint32_t>
+STROrder(const parlay::sequence<point_t> &centers, size_t leaf_size) {
+  size_t n = centers.size();
+  auto order = parlay::tabulate(n, [](size_t i) { return (uint32_t)i; });
+  // Ties are broken by index, so the order is deterministic
+  auto less_x = [&](uint32_t a, uint32_t b) {
+    return std::make_pair(centers[a].x(), a) <
+           std::make_pair(centers[b].x(), b);
+  };
+  auto less_y = [&](uint32_t a, uint32_t b) {
+    return std::make_pair(centers[a].y(), a) <
+           std::make_pair(centers[b].y(), b);
+  };
+
+  parlay::sort_inplace(order, less_x);
+
+  size_t n_leaves = (n + leaf_size - 1) / leaf_size;
+  size_t n_slabs = std::ceil(std::sqrt((double)n_leaves));
+  size_t slab_size = n_slabs * leaf_size;
+
+  parlay::parallel_for(0, n_slabs, [&](size_t slab) {
+    auto begin = std::min(slab * slab_size, n);
+    auto end = std::min(begin + slab_size, n);
+
+    std::sort(order.begin() + begin, order.begin() + end, less_y);
+  });
+
+  return std::vector<uint32_t>(order.begin(), order.end());
+}
+} // namespace detail
+
+template <typename GEOM_T>
+std::vector<uint32_t> SpatialOrder(const std::vector<GEOM_T> &geoms,
+                                   BenchmarkConfig::ReorderType type,
+                                   size_t leaf_size = BOOST_LEAF_SIZE) {
+  std::vector<uint32_t> order(geoms.size());
+
+  if (type == BenchmarkConfig::ReorderType::kNone || geoms.empty()) {
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    return order;
+  }
+
+  auto centers = parlay::tabulate(
+      geoms.size(), [&](size_t i) { return detail::Center(geoms[i]); });
+
+  if (type == BenchmarkConfig::ReorderType::kSTR) {
+    return detail::STROrder(centers, leaf_size);
+  }
+
+  box_t bounds;
+
+  boost::geometry::assign_inverse(bounds);
+  for (auto &p : centers) {
+    boost::geometry::expand(bounds, p);
+  }
+
+  double max_cell = (1u << detail::kCurveBits) - 1;
+  double min_x = bounds.min_corner().x(), min_y = bounds.min_corner().y();
+  double scale_x =
+      max_cell / std::max((double)bounds.max_corner().x() - min_x, 1e-9);
+  double scale_y =
+      max_cell / std::max((double)bounds.max_corner().y() - min_y, 1e-9);
+
+  auto quantize = [&](double v) {
+    return (bitmask_t)std::min(std::max(v, 0.0), max_cell);
+  };
+
+  // The index in the low bits breaks ties and makes the sort stable
+  auto keys = parlay::tabulate(geoms.size(), [&](size_t i) {
+    auto &p = centers[i];
+    bitmask_t coord[2] = {quantize((p.x() - min_x) * scale_x),
+                          quantize((p.y() - min_y) * scale_y)};
+    uint64_t code;
+
+    if (type == BenchmarkConfig::ReorderType::kHilbert) {
+      code = hilbert_c2i(2, detail::kCurveBits, coord);
+    } else {
+      code = detail::SpreadBits(coord[0]) | (detail::SpreadBits(coord[1]) << 1);
+    }
+    return (code << 32) | i;
+  });
+
+  parlay::integer_sort_inplace(keys, [](uint64_t key) { return key; });
+
+  parlay::parallel_for(0, keys.size(),
+                       [&](size_t i) { order[i] = (uint32_t)keys[i]; });
+  return order;
+}
+
+template <typename T>
+void Permute(std::vector<T> &items, const std::vector<uint32_t> &order) {
+  std::vector<T> permuted(items.size());
+
+  parlay::parallel_for(0, items.size(),
+                       [&](size_t i) { permuted[i] = items[order[i]]; });
+  items = std::move(permuted);
+}
+
+/**
+ * Sorts geoms in the given order and returns the permutation, or an empty one
+ * if they are left as loaded. The sort is timed on its own, what names the
+ * geometries in the report, and is not counted in loading or query time.
+ */
+template <typename GEOM_T>
+std::vector<uint32_t> Reorder(std::vector<GEOM_T> &geoms,
+                              BenchmarkConfig::ReorderType type,
+                              const std::string &what) {
+  if (type == BenchmarkConfig::ReorderType::kNone) {
+    return {};
+  }
+  Stopwatch sw;
+
+  sw.start();
+  auto order = SpatialOrder(geoms, type);
+  Permute(geoms, order);
+  sw.stop();
+
+  std::cout << what << " Reorder Time " << sw.ms() << " ms" << std::endl;
+  return order;
+}
+
+/**
+ * Rewrites (geom_id, query_id) results produced on reordered inputs back to
+ * the ids of the inputs as they were loaded. An empty order means the input
+ * was not reordered.
+ */
+inline void RestoreIds(std::vector<std::pair<uint32_t, uint32_t>> &results,
+                       const std::vector<uint32_t> &geom_order,
+                       const std::vector<uint32_t> &query_order) {
+  parlay::parallel_for(0, results.size(), [&](size_t i) {
+    auto &result = results[i];
+
+    if (!geom_order.empty()) {
+      result.first = geom_order[result.first];
+    }
+    if (!query_order.empty()) {
+      result.second = query_order[result.second];
+    }
+  });
+}
+
+#endif // SPATIALQUERYBENCHMARK_REORDER_H
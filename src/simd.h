@@ -0,0 +1,433 @@
+#ifndef SPATIALQUERYBENCHMARK_SIMD_H
+#define SPATIALQUERYBENCHMARK_SIMD_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Filter kernels over boxes stored as separate coordinate arrays. Each kernel
+ * writes the positions of the qualifying boxes to out, which must have room
+ * for n entries, and returns how many were written. All predicates are closed.
+ * The templates are the scalar fallback, float gets AVX2 overloads when the
+ * target has it.
+ */
+namespace simd {
+
+template <typename T>
+inline size_t FilterIntersects(const T *xmin, const T *ymin, const T *xmax,
+                               const T *ymax, size_t n, T q_xmin, T q_ymin,
+                               T q_xmax, T q_ymax, uint32_t *out) {
+  size_t n_out = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    out[n_out] = i;
+    n_out += xmin[i] <= q_xmax && xmax[i] >= q_xmin && ymin[i] <= q_ymax &&
+             ymax[i] >= q_ymin;
+  }
+  return n_out;
+}
+
+template <typename T>
+inline size_t FilterContains(const T *xmin, const T *ymin, const T *xmax,
+                             const T *ymax, size_t n, T q_xmin, T q_ymin,
+                             T q_xmax, T q_ymax, uint32_t *out) {
+  size_t n_out = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    out[n_out] = i;
+    n_out += xmin[i] <= q_xmin && xmax[i] >= q_xmax && ymin[i] <= q_ymin &&
+             ymax[i] >= q_ymax;
+  }
+  return n_out;
+}
+
+// Boxes inside the query, the converse of FilterContains
+template <typename T>
+inline size_t FilterWithin(const T *xmin, const T *ymin, const T *xmax,
+                           const T *ymax, size_t n, T q_xmin, T q_ymin,
+                           T q_xmax, T q_ymax, uint32_t *out) {
+  size_t n_out = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    out[n_out] = i;
+    n_out += xmin[i] >= q_xmin && xmax[i] <= q_xmax && ymin[i] >= q_ymin &&
+             ymax[i] <= q_ymax;
+  }
+  return n_out;
+}
+
+template <typename T>
+inline size_t FilterContainsPoint(const T *xmin, const T *ymin, const T *xmax,
+                                  const T *ymax, size_t n, T x, T y,
+                                  uint32_t *out) {
+  return FilterContains(xmin, ymin, xmax, ymax, n, x, y, x, y, out);
+}
+
+/**
+ * Keeps the boxes whose distance to the query box is at most dist, with
+ * max_dist2 = dist * dist. A point query is a degenerate query box.
+ */
+template <typename T>
+inline size_t FilterWithinDistance(const T *xmin, const T *ymin,
+                                   const T *xmax, const T *ymax, size_t n,
+                                   T q_xmin, T q_ymin, T q_xmax, T q_ymax,
+                                   T max_dist2, uint32_t *out) {
+  size_t n_out = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    T dx = std::max(std::max(xmin[i] - q_xmax, q_xmin - xmax[i]), T(0));
+    T dy = std::max(std::max(ymin[i] - q_ymax, q_ymin - ymax[i]), T(0));
+
+    out[n_out] = i;
+    n_out += dx * dx + dy * dy <= max_dist2;
+  }
+  return n_out;
+}
+
+/**
+ * Parity of the crossings of a ray from (px, py) towards +x with the edges of
+ * a closed vertex list, as in pnpoly: edge i joins vertex i - 1 to vertex i
+ * and edge 0 closes the list. Returns 1 if the point is inside.
+ */
+template <typename T>
+inline int CrossingParity(const T *x, const T *y, size_t n, T px, T py) {
+  int c = 0;
+
+  for (size_t i = 0, j = n - 1; i < n; j = i++) {
+    c ^= ((y[i] > py) != (y[j] > py)) &&
+         (px < (x[j] - x[i]) * (py - y[i]) / (y[j] - y[i]) + x[i]);
+  }
+  return c;
+}
+
+/**
+ * The same parity over separate edges, edge i joins (x0[i], y0[i]) to
+ * (x1[i], y1[i]). Only the edges straddling py matter, so any subset holding
+ * all of them gives the same answer.
+ */
+template <typename T>
+inline int EdgeCrossingParity(const T *x0, const T *y0, const T *x1,
+                              const T *y1, size_t n, T px, T py) {
+  int c = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    c ^= ((y0[i] > py) != (y1[i] > py)) &&
+         (px < (x1[i] - x0[i]) * (py - y0[i]) / (y1[i] - y0[i]) + x0[i]);
+  }
+  return c;
+}
+
+/**
+ * Whether any segment of a polyline meets the query box, segment i joining
+ * vertex i to vertex i + 1. A segment misses the box when their extents are
+ * apart or all four corners lie strictly on one side of its line. With
+ * kInterior only the open box counts, so touching its border is a miss.
+ */
+template <bool kInterior, typename T>
+inline bool AnySegmentIntersects(const T *x, const T *y, size_t n, T q_xmin,
+                                 T q_ymin, T q_xmax, T q_ymax) {
+  for (size_t i = 0; i + 1 < n; i++) {
+    T x_lo = std::min(x[i], x[i + 1]), x_hi = std::max(x[i], x[i + 1]);
+    T y_lo = std::min(y[i], y[i + 1]), y_hi = std::max(y[i], y[i + 1]);
+    bool apart = kInterior ? x_lo >= q_xmax || x_hi <= q_xmin ||
+                                 y_lo >= q_ymax || y_hi <= q_ymin
+                           : x_lo > q_xmax || x_hi < q_xmin || y_lo > q_ymax ||
+                                 y_hi < q_ymin;
+
+    if (apart) {
+      continue;
+    }
+    T dx = x[i + 1] - x[i], dy = y[i + 1] - y[i];
+    T f[4] = {dx * (q_ymin - y[i]) - dy * (q_xmin - x[i]),
+              dx * (q_ymax - y[i]) - dy * (q_xmin - x[i]),
+              dx * (q_ymin - y[i]) - dy * (q_xmax - x[i]),
+              dx * (q_ymax - y[i]) - dy * (q_xmax - x[i])};
+    bool above = true, below = true;
+
+    for (auto v : f) {
+      above &= kInterior ? v >= 0 : v > 0;
+      below &= kInterior ? v <= 0 : v < 0;
+    }
+    if (!above && !below) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#if defined(__AVX2__)
+namespace detail {
+inline size_t EmitMask(int mask, size_t base, uint32_t *out) {
+  size_t n_out = 0;
+
+  while (mask != 0) {
+    out[n_out++] = base + __builtin_ctz(mask);
+    mask &= mask - 1;
+  }
+  return n_out;
+}
+
+// Parity of the crossings of eight edges from vertex i to vertex j
+inline int CrossingMaskParity(__m256 xi, __m256 yi, __m256 xj, __m256 yj,
+                              __m256 v_px, __m256 v_py) {
+  __m256 straddles = _mm256_xor_ps(_mm256_cmp_ps(yi, v_py, _CMP_GT_OQ),
+                                   _mm256_cmp_ps(yj, v_py, _CMP_GT_OQ));
+  // Horizontal edges do not straddle, their division by zero is masked out
+  __m256 x_cross = _mm256_add_ps(
+      _mm256_div_ps(
+          _mm256_mul_ps(_mm256_sub_ps(xj, xi), _mm256_sub_ps(v_py, yi)),
+          _mm256_sub_ps(yj, yi)),
+      xi);
+  __m256 m =
+      _mm256_and_ps(straddles, _mm256_cmp_ps(v_px, x_cross, _CMP_LT_OQ));
+
+  return __builtin_popcount(_mm256_movemask_ps(m)) & 1;
+}
+} // namespace detail
+
+inline size_t FilterIntersects(const float *xmin, const float *ymin,
+                               const float *xmax, const float *ymax, size_t n,
+                               float q_xmin, float q_ymin, float q_xmax,
+                               float q_ymax, uint32_t *out) {
+  const __m256 v_q_xmin = _mm256_set1_ps(q_xmin);
+  const __m256 v_q_ymin = _mm256_set1_ps(q_ymin);
+  const __m256 v_q_xmax = _mm256_set1_ps(q_xmax);
+  const __m256 v_q_ymax = _mm256_set1_ps(q_ymax);
+  size_t n_out = 0;
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256 m = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(xmin + i), v_q_xmax, _CMP_LE_OQ),
+        _mm256_cmp_ps(_mm256_loadu_ps(xmax + i), v_q_xmin, _CMP_GE_OQ));
+    m = _mm256_and_ps(
+        m, _mm256_cmp_ps(_mm256_loadu_ps(ymin + i), v_q_ymax, _CMP_LE_OQ));
+    m = _mm256_and_ps(
+        m, _mm256_cmp_ps(_mm256_loadu_ps(ymax + i), v_q_ymin, _CMP_GE_OQ));
+    n_out += detail::EmitMask(_mm256_movemask_ps(m), i, out + n_out);
+  }
+
+  for (; i < n; i++) {
+    out[n_out] = i;
+    n_out += xmin[i] <= q_xmax && xmax[i] >= q_xmin && ymin[i] <= q_ymax &&
+             ymax[i] >= q_ymin;
+  }
+  return n_out;
+}
+
+inline size_t FilterContains(const float *xmin, const float *ymin,
+                             const float *xmax, const float *ymax, size_t n,
+                             float q_xmin, float q_ymin, float q_xmax,
+                             float q_ymax, uint32_t *out) {
+  const __m256 v_q_xmin = _mm256_set1_ps(q_xmin);
+  const __m256 v_q_ymin = _mm256_set1_ps(q_ymin);
+  const __m256 v_q_xmax = _mm256_set1_ps(q_xmax);
+  const __m256 v_q_ymax = _mm256_set1_ps(q_ymax);
+  size_t n_out = 0;
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256 m = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(xmin + i), v_q_xmin, _CMP_LE_OQ),
+        _mm256_cmp_ps(_mm256_loadu_ps(xmax + i), v_q_xmax, _CMP_GE_OQ));
+    m = _mm256_and_ps(
+        m, _mm256_cmp_ps(_mm256_loadu_ps(ymin + i), v_q_ymin, _CMP_LE_OQ));
+    m = _mm256_and_ps(
+        m, _mm256_cmp_ps(_mm256_loadu_ps(ymax + i), v_q_ymax, _CMP_GE_OQ));
+    n_out += detail::EmitMask(_mm256_movemask_ps(m), i, out + n_out);
+  }
+
+  for (; i < n; i++) {
+    out[n_out] = i;
+    n_out += xmin[i] <= q_xmin && xmax[i] >= q_xmax && ymin[i] <= q_ymin &&
+             ymax[i] >= q_ymax;
+  }
+  return n_out;
+}
+
+inline size_t FilterWithin(const float *xmin, const float *ymin,
+                           const float *xmax, const float *ymax, size_t n,
+                           float q_xmin, float q_ymin, float q_xmax,
+                           float q_ymax, uint32_t *out) {
+  const __m256 v_q_xmin = _mm256_set1_ps(q_xmin);
+  const __m256 v_q_ymin = _mm256_set1_ps(q_ymin);
+  const __m256 v_q_xmax = _mm256_set1_ps(q_xmax);
+  const __m256 v_q_ymax = _mm256_set1_ps(q_ymax);
+  size_t n_out = 0;
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256 m = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(xmin + i), v_q_xmin, _CMP_GE_OQ),
+        _mm256_cmp_ps(_mm256_loadu_ps(xmax + i), v_q_xmax, _CMP_LE_OQ));
+    m = _mm256_and_ps(
+        m, _mm256_cmp_ps(_mm256_loadu_ps(ymin + i), v_q_ymin, _CMP_GE_OQ));
+    m = _mm256_and_ps(
+        m, _mm256_cmp_ps(_mm256_loadu_ps(ymax + i), v_q_ymax, _CMP_LE_OQ));
+    n_out += detail::EmitMask(_mm256_movemask_ps(m), i, out + n_out);
+  }
+
+  for (; i < n; i++) {
+    out[n_out] = i;
+    n_out += xmin[i] >= q_xmin && xmax[i] <= q_xmax && ymin[i] >= q_ymin &&
+             ymax[i] <= q_ymax;
+  }
+  return n_out;
+}
+
+inline size_t FilterContainsPoint(const float *xmin, const float *ymin,
+                                  const float *xmax, const float *ymax,
+                                  size_t n, float x, float y, uint32_t *out) {
+  return FilterContains(xmin, ymin, xmax, ymax, n, x, y, x, y, out);
+}
+
+inline size_t FilterWithinDistance(const float *xmin, const float *ymin,
+                                   const float *xmax, const float *ymax,
+                                   size_t n, float q_xmin, float q_ymin,
+                                   float q_xmax, float q_ymax, float max_dist2,
+                                   uint32_t *out) {
+  const __m256 v_q_xmin = _mm256_set1_ps(q_xmin);
+  const __m256 v_q_ymin = _mm256_set1_ps(q_ymin);
+  const __m256 v_q_xmax = _mm256_set1_ps(q_xmax);
+  const __m256 v_q_ymax = _mm256_set1_ps(q_ymax);
+  const __m256 v_max_dist2 = _mm256_set1_ps(max_dist2);
+  const __m256 v_zero = _mm256_setzero_ps();
+  size_t n_out = 0;
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256 dx = _mm256_max_ps(
+        _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(xmin + i), v_q_xmax),
+                      _mm256_sub_ps(v_q_xmin, _mm256_loadu_ps(xmax + i))),
+        v_zero);
+    __m256 dy = _mm256_max_ps(
+        _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(ymin + i), v_q_ymax),
+                      _mm256_sub_ps(v_q_ymin, _mm256_loadu_ps(ymax + i))),
+        v_zero);
+    __m256 dist2 =
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    __m256 m = _mm256_cmp_ps(dist2, v_max_dist2, _CMP_LE_OQ);
+
+    n_out += detail::EmitMask(_mm256_movemask_ps(m), i, out + n_out);
+  }
+
+  for (; i < n; i++) {
+    float dx = std::max(std::max(xmin[i] - q_xmax, q_xmin - xmax[i]), 0.0f);
+    float dy = std::max(std::max(ymin[i] - q_ymax, q_ymin - ymax[i]), 0.0f);
+
+    out[n_out] = i;
+    n_out += dx * dx + dy * dy <= max_dist2;
+  }
+  return n_out;
+}
+
+inline int CrossingParity(const float *x, const float *y, size_t n, float px,
+                          float py) {
+  if (n == 0) {
+    return 0;
+  }
+  const __m256 v_px = _mm256_set1_ps(px);
+  const __m256 v_py = _mm256_set1_ps(py);
+  // The closing edge, the others are vertex i - 1 to vertex i
+  int c = ((y[0] > py) != (y[n - 1] > py)) &&
+          (px < (x[n - 1] - x[0]) * (py - y[0]) / (y[n - 1] - y[0]) + x[0]);
+  size_t i = 1;
+
+  for (; i + 8 <= n; i += 8) {
+    c ^= detail::CrossingMaskParity(
+        _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i),
+        _mm256_loadu_ps(x + i - 1), _mm256_loadu_ps(y + i - 1), v_px, v_py);
+  }
+
+  for (; i < n; i++) {
+    c ^= ((y[i] > py) != (y[i - 1] > py)) &&
+         (px < (x[i - 1] - x[i]) * (py - y[i]) / (y[i - 1] - y[i]) + x[i]);
+  }
+  return c;
+}
+
+inline int EdgeCrossingParity(const float *x0, const float *y0,
+                              const float *x1, const float *y1, size_t n,
+                              float px, float py) {
+  const __m256 v_px = _mm256_set1_ps(px);
+  const __m256 v_py = _mm256_set1_ps(py);
+  int c = 0;
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    c ^= detail::CrossingMaskParity(
+        _mm256_loadu_ps(x0 + i), _mm256_loadu_ps(y0 + i),
+        _mm256_loadu_ps(x1 + i), _mm256_loadu_ps(y1 + i), v_px, v_py);
+  }
+
+  for (; i < n; i++) {
+    c ^= ((y0[i] > py) != (y1[i] > py)) &&
+         (px < (x1[i] - x0[i]) * (py - y0[i]) / (y1[i] - y0[i]) + x0[i]);
+  }
+  return c;
+}
+template <bool kInterior>
+inline bool AnySegmentIntersects(const float *x, const float *y, size_t n,
+                                 float q_xmin, float q_ymin, float q_xmax,
+                                 float q_ymax) {
+  // Strict comparisons for the open box, the rest flip accordingly
+  constexpr int kLT = kInterior ? _CMP_LT_OQ : _CMP_LE_OQ;
+  constexpr int kGT = kInterior ? _CMP_GT_OQ : _CMP_GE_OQ;
+  constexpr int kAbove = kInterior ? _CMP_GE_OQ : _CMP_GT_OQ;
+  constexpr int kBelow = kInterior ? _CMP_LE_OQ : _CMP_LT_OQ;
+  const __m256 v_q_xmin = _mm256_set1_ps(q_xmin);
+  const __m256 v_q_ymin = _mm256_set1_ps(q_ymin);
+  const __m256 v_q_xmax = _mm256_set1_ps(q_xmax);
+  const __m256 v_q_ymax = _mm256_set1_ps(q_ymax);
+  const __m256 v_zero = _mm256_setzero_ps();
+  size_t i = 0;
+
+  for (; i + 9 <= n; i += 8) {
+    __m256 x0 = _mm256_loadu_ps(x + i), x1 = _mm256_loadu_ps(x + i + 1);
+    __m256 y0 = _mm256_loadu_ps(y + i), y1 = _mm256_loadu_ps(y + i + 1);
+    __m256 overlap = _mm256_and_ps(
+        _mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(x0, x1), v_q_xmax, kLT),
+                      _mm256_cmp_ps(_mm256_max_ps(x0, x1), v_q_xmin, kGT)),
+        _mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(y0, y1), v_q_ymax, kLT),
+                      _mm256_cmp_ps(_mm256_max_ps(y0, y1), v_q_ymin, kGT)));
+
+    if (_mm256_movemask_ps(overlap) == 0) {
+      continue;
+    }
+    __m256 dx = _mm256_sub_ps(x1, x0), dy = _mm256_sub_ps(y1, y0);
+    __m256 rx_min = _mm256_sub_ps(v_q_xmin, x0);
+    __m256 rx_max = _mm256_sub_ps(v_q_xmax, x0);
+    __m256 ry_min = _mm256_sub_ps(v_q_ymin, y0);
+    __m256 ry_max = _mm256_sub_ps(v_q_ymax, y0);
+    __m256 f[4] = {
+        _mm256_sub_ps(_mm256_mul_ps(dx, ry_min), _mm256_mul_ps(dy, rx_min)),
+        _mm256_sub_ps(_mm256_mul_ps(dx, ry_max), _mm256_mul_ps(dy, rx_min)),
+        _mm256_sub_ps(_mm256_mul_ps(dx, ry_min), _mm256_mul_ps(dy, rx_max)),
+        _mm256_sub_ps(_mm256_mul_ps(dx, ry_max), _mm256_mul_ps(dy, rx_max))};
+    __m256 above = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    __m256 below = above;
+
+    for (auto v : f) {
+      above = _mm256_and_ps(above, _mm256_cmp_ps(v, v_zero, kAbove));
+      below = _mm256_and_ps(below, _mm256_cmp_ps(v, v_zero, kBelow));
+    }
+    __m256 hit = _mm256_andnot_ps(_mm256_or_ps(above, below), overlap);
+
+    if (_mm256_movemask_ps(hit) != 0) {
+      return true;
+    }
+  }
+
+  // The scalar template, picked explicitly so it does not recurse here
+  return AnySegmentIntersects<kInterior, float>(x + i, y + i, n - i, q_xmin,
+                                                q_ymin, q_xmax, q_ymax);
+}
+#endif
+
+} // namespace simd
+
+#endif // SPATIALQUERYBENCHMARK_SIMD_H
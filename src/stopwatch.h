@@ -21,5 +21,11 @@ public:
                .count() /
            1000.0;
   }
+
+  double us() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1)
+               .count() /
+           1000.0;
+  }
 };
 #endif // UTIL_STOPWATCH_H
@@ -2,19 +2,38 @@
 #ifndef SPATIALQUERYBENCHMARK_TIME_STAT_H
 #define SPATIALQUERYBENCHMARK_TIME_STAT_H
 #include <stdlib.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 struct time_stat {
   std::vector<double> query_ms;
   std::vector<double> query_ms_after_update;
   std::vector<double> insert_ms;
   std::vector<double> delete_ms;
+  // Exact tests of the filter candidates, for queries that refine them
+  std::vector<double> refine_ms;
+  // Grouping the results by query, with -csr
+  std::vector<double> group_ms;
   std::vector<double> update_ms;
   size_t num_geoms = 0;
   size_t num_queries = 0;
   size_t num_results = 0;
+  // Filter candidates of queries that refine them, 0 otherwise
+  size_t num_candidates = 0;
   size_t num_inserts = 0;
   size_t num_deletes = 0;
   size_t num_updates = 0;
+  // Latency of every query in the last run, for backends that time each one
+  std::vector<double> query_latency_us;
+  // (geom_id, query_id) of the last run, for backends that report ids
+  std::vector<std::pair<uint32_t, uint32_t>> results;
+  // The results grouped by query with -csr, the geom ids of query i are
+  // result_geoms[result_offsets[i], result_offsets[i + 1])
+  std::vector<size_t> result_offsets;
+  std::vector<uint32_t> result_geoms;
+  // Scratch the grouping needs on top of the two arrays above
+  size_t group_scratch_bytes = 0;
 };
 
 #endif // SPATIALQUERYBENCHMARK_TIME_STAT_H
@@ -255,6 +255,38 @@ if(piece_) {
             index_refine_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_refine - start_refine);
         }
 
+        /*
+         * glin_find for concurrent readers, it writes nothing in the index.
+         * The probe and refine time is added to the caller's counters, and the
+         * leaf is found with the lookups that leave ALEX's statistics alone
+         */
+        void glin_find(geos::geom::Geometry *query_window, const std::string &curve_type,
+                       double cell_xmin, double cell_ymin,
+                       double cell_x_intvl, double cell_y_intvl,
+                       const std::vector<std::tuple<double, double, double, double>> &pieces,
+                       std::vector<geos::geom::Geometry *> &find_result,
+                       int &count_filter,
+                       std::chrono::nanoseconds &probe_duration,
+                       std::chrono::nanoseconds &refine_duration) const {
+            auto start_find = std::chrono::high_resolution_clock::now();
+            double min_start;
+            double max_end;
+            probe_curve_range(query_window, curve_type, cell_xmin, cell_ymin,
+                              cell_x_intvl, cell_y_intvl, pieces, min_start, max_end);
+            auto *leaf = this->get_leaf_no_stats(min_start);
+            typename alex::Alex<T, P>::Iterator it_start(leaf, leaf->find_lower_no_stats(min_start));
+            auto end_find = std::chrono::high_resolution_clock::now();
+            probe_duration += std::chrono::duration_cast<std::chrono::nanoseconds>(end_find - start_find);
+
+            auto start_refine = std::chrono::high_resolution_clock::now();
+            int num_visited_leaf;
+            int num_loaded_leaf;
+            refine_with_curveseg(query_window, it_start, max_end, find_result, count_filter,
+                                 num_visited_leaf, num_loaded_leaf);
+            auto end_refine = std::chrono::high_resolution_clock::now();
+            refine_duration += std::chrono::duration_cast<std::chrono::nanoseconds>(end_refine - start_refine);
+        }
+
         /*
          * original index probe with line projection
          */
@@ -293,16 +325,32 @@ if(piece_) {
                  double cell_xmin, double cell_ymin,
                  double cell_x_intvl, double cell_y_intvl,
                  std::vector<std::tuple<double, double, double, double>> &pieces) {
-            // project + augment
             double min_start;
             double max_end;
+            probe_curve_range(query_window, curve_type, cell_xmin, cell_ymin, cell_x_intvl, cell_y_intvl,
+                              pieces, min_start, max_end);
+            auto it_start = alex::Alex<T, P>::lower_bound(min_start);
+//            auto it_end = alex::Alex<T, P>::upper_bound(max_end);
+//            return std::make_pair(it_start, it_end);
+            return std::make_pair(it_start, max_end);
+        }
+
+        /*
+         *  curve range of a query window, with the start augmented by the pieces
+         */
+        void probe_curve_range(geos::geom::Geometry *query_window, const std::string &curve_type,
+                               double cell_xmin, double cell_ymin,
+                               double cell_x_intvl, double cell_y_intvl,
+                               const std::vector<std::tuple<double, double, double, double>> &pieces,
+                               double &min_start, double &max_end) const {
+            // project + augment
             curve_shape_projection(query_window, curve_type, cell_xmin, cell_ymin, cell_x_intvl, cell_y_intvl,
                                    min_start, max_end);
             //   std::cout << "find poly start" << min_start << " find poly end " << max_end << endl;
     if(piece_) {
               // use current end point to search which bucket the records belong
               // to
-              std::vector<std::tuple<double, double, double, double>>::iterator
+              std::vector<std::tuple<double, double, double, double>>::const_iterator
                   it;
               it = std::lower_bound(pieces.begin(), pieces.end(),
                                     std::make_tuple(min_start, -1, -1, -1),
@@ -326,10 +374,6 @@ if(piece_) {
             assert(current_end <= std::get<0>(pieces[up - pieces.begin() ]));
             assert(current_end > std::get<0>(pieces[(up - pieces.begin() - 1)]));
 #endif
-            auto it_start = alex::Alex<T, P>::lower_bound(min_start);
-//            auto it_end = alex::Alex<T, P>::upper_bound(max_end);
-//            return std::make_pair(it_start, it_end);
-            return std::make_pair(it_start, max_end);
         }
 
         /*
@@ -384,6 +428,17 @@ if(piece_) {
          */
         void refine_with_curveseg(geos::geom::Geometry *query_window, typename alex::Alex<T, P>::Iterator it_start, double max_end,
                                   std::vector<geos::geom::Geometry *> &find_result, int &count_filter) {
+            int num_visited_leaf;
+            int num_loaded_leaf;
+            refine_with_curveseg(query_window, it_start, max_end, find_result, count_filter,
+                                 num_visited_leaf, num_loaded_leaf);
+            avg_num_visited_leaf = num_visited_leaf;
+            avg_num_loaded_leaf = num_loaded_leaf;
+        }
+
+        void refine_with_curveseg(geos::geom::Geometry *query_window, typename alex::Alex<T, P>::Iterator it_start, double max_end,
+                                  std::vector<geos::geom::Geometry *> &find_result, int &count_filter,
+                                  int &num_visited_leaf, int &num_loaded_leaf) const {
             // refine the query result
             typename alex::Alex<T, P>::Iterator it;
             geos::geom::Envelope env_query_window = *query_window->getEnvelopeInternal();
@@ -405,8 +460,8 @@ if(piece_) {
             }
 //            assert(find_result.size() != 0);
 //            assert(count_filter!=0);
-            avg_num_visited_leaf = it.num_visited_leaf;
-            avg_num_loaded_leaf = it.num_loaded_leaf;
+            num_visited_leaf = it.num_visited_leaf;
+            num_loaded_leaf = it.num_loaded_leaf;
 //            std::cout << "num visited leaf " << it.num_visited_leaf << " num loaded leaf " << it.num_loaded_leaf << std::endl;
         }
 
@@ -483,6 +483,43 @@ namespace alex {
   }
 #endif
 
+        // Same as get_leaf(), but updates no lookup statistics, so several
+        // threads can look up at once
+        data_node_type *get_leaf_no_stats(T key) const {
+            AlexNode<T, P> *cur = root_node_;
+
+            while (!cur->is_leaf_) {
+                auto node = static_cast<model_node_type *>(cur);
+                double bucketID_prediction = node->model_.predict_double(key);
+                int bucketID = static_cast<int>(bucketID_prediction);
+                bucketID =
+                        std::min<int>(std::max<int>(bucketID, 0), node->num_children_ - 1);
+                cur = node->children_[bucketID];
+#if ALEX_SAFE_LOOKUP
+                if (cur->is_leaf_) {
+                    auto leaf = static_cast<data_node_type *>(cur);
+                    int bucketID_prediction_rounded =
+                            static_cast<int>(bucketID_prediction + 0.5);
+                    double tolerance =
+                            10 * std::numeric_limits<double>::epsilon() * bucketID_prediction;
+                    if (std::abs(bucketID_prediction - bucketID_prediction_rounded) <=
+                        tolerance) {
+                        if (bucketID_prediction_rounded <= bucketID_prediction) {
+                            if (leaf->prev_leaf_ && leaf->prev_leaf_->last_key() >= key) {
+                                return leaf->prev_leaf_;
+                            }
+                        } else {
+                            if (leaf->next_leaf_ && leaf->next_leaf_->first_key() <= key) {
+                                return leaf->next_leaf_;
+                            }
+                        }
+                    }
+                }
+#endif
+            }
+            return static_cast<data_node_type *>(cur);
+        }
+
     private:
         // Make a correction to the traversal path to instead point to the leaf node
         // that is to the left or right of the current leaf node.
@@ -1489,6 +1489,31 @@ namespace alex {
             return get_next_filled_position(pos, false);
         }
 
+        // Same as find_lower(), but updates no lookup statistics, so several
+        // threads can search the same node
+        int find_lower_no_stats(const T &key) const {
+            int m = predict_position(key);
+            int bound = 1;
+            int l, r;  // will do binary search in range [l, r)
+            if (key_greaterequal(ALEX_DATA_NODE_KEY_AT(m), key)) {
+                int size = m;
+                while (bound < size &&
+                       key_greaterequal(ALEX_DATA_NODE_KEY_AT(m - bound), key)) {
+                    bound *= 2;
+                }
+                l = m - std::min<int>(bound, size);
+                r = m - bound / 2;
+            } else {
+                int size = data_capacity_ - m;
+                while (bound < size && key_less(ALEX_DATA_NODE_KEY_AT(m + bound), key)) {
+                    bound *= 2;
+                }
+                l = m + bound / 2;
+                r = m + std::min<int>(bound, size);
+            }
+            return get_next_filled_position(binary_search_lower_bound(l, r, key), false);
+        }
+
         // Searches for the first non-gap position greater than key
         // Returns position in range [0, data_capacity]
         // Compare with upper_bound()
@@ -59,16 +59,15 @@ void curve_shape_projection(geos::geom::Geometry *geometry,
   double maxX = envelope->getMaxX();
   double maxY = envelope->getMaxY();
 
-  auto encoder =
-      new Encoder<double>(cell_xmin, cell_x_intvl, cell_ymin, cell_y_intvl);
+  Encoder<double> encoder(cell_xmin, cell_x_intvl, cell_ymin, cell_y_intvl);
 
   if (curve_type == "h") {
-    auto index_double_h = encoder->encode_h(minX, minY, maxX, maxY);
+    auto index_double_h = encoder.encode_h(minX, minY, maxX, maxY);
     dist_start = index_double_h.first;
     dist_end = index_double_h.second;
   }
   if (curve_type == "z") {
-    auto index_z = encoder->encode_z(minX, minY, maxX, maxY);
+    auto index_z = encoder.encode_z(minX, minY, maxX, maxY);
     dist_start = index_z.first;
     dist_end = index_z.second;
   }
@@ -86,16 +85,15 @@ void curve_shape_projection(geos::geom::Envelope *envelope,
   double maxX = envelope->getMaxX();
   double maxY = envelope->getMaxY();
 
-  auto encoder =
-      new Encoder<double>(cell_xmin, cell_x_intvl, cell_ymin, cell_y_intvl);
+  Encoder<double> encoder(cell_xmin, cell_x_intvl, cell_ymin, cell_y_intvl);
 
   if (curve_type == "h") {
-    auto index_double_h = encoder->encode_h(minX, minY, maxX, maxY);
+    auto index_double_h = encoder.encode_h(minX, minY, maxX, maxY);
     dist_start = index_double_h.first;
     dist_end = index_double_h.second;
   }
   if (curve_type == "z") {
-    auto index_z = encoder->encode_z(minX, minY, maxX, maxY);
+    auto index_z = encoder.encode_z(minX, minY, maxX, maxY);
     dist_start = index_z.first;
     dist_end = index_z.second;
   }